@@ -6,3 +6,13 @@ $CC $CFLAGS $LIB_FUZZING_ENGINE \
   $SRC/corejson/source/core_json.c \
   -I$SRC/corejson/source/include \
   -o $OUT/validate_fuzzer
+
+# These fuzzers use the counters to fail on inputs that take more than
+# linear work.
+for fuzzer in search_fuzzer iterate_fuzzer; do
+  $CC $CFLAGS $LIB_FUZZING_ENGINE -DJSON_ENABLE_STATS \
+    $SRC/corejson/.clusterfuzzlite/$fuzzer.c \
+    $SRC/corejson/source/core_json.c \
+    -I$SRC/corejson/source/include \
+    -o $OUT/$fuzzer
+done
@@ -0,0 +1,43 @@
+#include <core_json.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Each value, string, collection, escape and UTF-8 sequence counted by the
+ * library takes at least one byte of the document, so a pass over each byte
+ * takes a bounded number of steps per byte. */
+static size_t steps(const JSONStats_t *stats) {
+  return stats->valuesScanned + stats->collectionsSkipped +
+         stats->stringsSkipped + stats->escapesSkipped + stats->utf8Skipped;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  JSONStats_t stats = { 0 };
+  JSONStats_t zero = { 0 };
+  JSONPair_t pair;
+  size_t start = 0, next = 0;
+
+  JSON_SetStats(&stats);
+
+  if (JSON_Validate((const char *)data, size) == JSONSuccess) {
+    /* Validation passes over the document once. */
+    if (steps(&stats) > size) {
+      abort();
+    }
+
+    stats = zero;
+
+    while (JSON_Iterate((const char *)data, size, &start, &next, &pair) ==
+           JSONSuccess) {
+    }
+
+    /* Iteration resumes where it left off, so it too passes over each value
+     * once. */
+    if (steps(&stats) > (2 * size)) {
+      abort();
+    }
+  }
+
+  JSON_SetStats(NULL);
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <core_json.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Each value, string, collection, escape and UTF-8 sequence counted by the
+ * library takes at least one byte of the document, so a search that passes
+ * over each byte a bounded number of times takes a bounded number of steps
+ * per byte. */
+static size_t steps(const JSONStats_t *stats) {
+  return stats->valuesScanned + stats->collectionsSkipped +
+         stats->stringsSkipped + stats->escapesSkipped + stats->utf8Skipped;
+}
+
+/* The first byte is the query length; the query and document follow. */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  JSONStats_t stats = { 0 };
+  const char *value;
+  size_t valueLength, queryLength, parts = 1, i;
+
+  if (size < 1) {
+    return 0;
+  }
+
+  queryLength = data[0];
+  data++;
+  size--;
+
+  if (queryLength > size) {
+    return 0;
+  }
+
+  for (i = 0; i < queryLength; i++) {
+    if ((data[i] == '.') || (data[i] == '[')) {
+      parts++;
+    }
+  }
+
+  JSON_SetStats(&stats);
+  JSON_SearchConst((const char *)&data[queryLength], size - queryLength,
+                   (const char *)data, queryLength, &value, &valueLength, NULL);
+  JSON_SetStats(NULL);
+
+  /* The document is validated once, and each part of a query passes over
+   * at most the value matched by the previous part. */
+  if (steps(&stats) > (2 * (parts + 1) * (size - queryLength))) {
+    abort();
+  }
+
+  return 0;
+}
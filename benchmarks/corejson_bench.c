@@ -0,0 +1,678 @@
+/*
+ * coreJSON
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file corejson_bench.c
+ * @brief Measures the throughput of the coreJSON API.
+ *
+ * Each operation is repeated until it has run for a minimum time, and the
+ * mean time per operation and throughput are reported.  Results are written
+ * to stdout as a JSON document, so runs on the same machine can be compared
+ * across commits.
+ *
+ * Generated corpora modeled on AWS IoT device shadow, jobs, and telemetry
+ * messages are always measured, as are documents from the generator in
+ * generator.c that stress particular shapes.  Files named on the command line, such as
+ * twitter.json, citm_catalog.json, and canada.json, are measured as well.
+ *
+ * Usage:
+ *     corejson-bench [-t SECONDS] [-q QUERY]... [FILE...]
+ *
+ * Each -q query is searched for in every file.  For searches, mb_per_s is
+ * computed from the length of the whole document.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core_json.h"
+#include "generator.h"
+
+/**
+ * @brief The default minimum time to run each operation, in seconds.
+ */
+#define DEFAULT_MIN_SECONDS    0.2
+
+/**
+ * @brief The maximum number of -q queries.
+ */
+#define MAX_QUERIES            16
+
+/**
+ * @brief The capacity of the structural index for opIndexThenSearch.
+ */
+#define INDEX_CAPACITY         65536
+
+/**
+ * @brief A search query for a corpus, with the name under which it is reported.
+ */
+typedef struct
+{
+    const char * name;
+    const char * query;
+} namedQuery_t;
+
+/**
+ * @brief A document to measure.
+ */
+typedef struct
+{
+    const char * name;
+    const char * buf;
+    size_t length;
+    const namedQuery_t * queries;
+    size_t queryCount;
+    const char * wildcard; /* A query with "[*]" for opEachSearch, or NULL. */
+} corpus_t;
+
+/**
+ * @brief The operation to time.
+ */
+typedef enum
+{
+    opValidate,
+    opSearch,
+    opTrustedSearch,
+    opStartSearch, /* JSON_SearchStart, which does not read the value found. */
+    opEachSearch,  /* JSON_SearchEach, counting the values matched. */
+    opIterate,
+    opValidateThenSearch, /* JSON_Validate, then every query of the corpus. */
+    opIndexThenSearch     /* The same, using JSON_ValidateAndIndex. */
+} op_t;
+
+static double minSeconds = DEFAULT_MIN_SECONDS;
+static int firstResult = 1;
+static JSONIndexEntry_t indexEntries[ INDEX_CAPACITY ];
+
+/**
+ * @brief Count a value matched by JSON_SearchEach().
+ *
+ * @param[in] context  The count.
+ * @param[in] value  The value matched.
+ *
+ * @return true, to continue the search.
+ */
+static bool countMatch( void * context,
+                        const JSONCursor_t * value )
+{
+    ( void ) value;
+    ( *( size_t * ) context )++;
+
+    return true;
+}
+
+/**
+ * @brief Generate a device shadow document with desired and reported state.
+ *
+ * @param[out] b  The buffer to receive the document.
+ */
+static void makeShadow( buffer_t * b )
+{
+    int i;
+
+    genAppend( b, "{\"state\":{\"desired\":{" );
+
+    for( i = 0; i < 64; i++ )
+    {
+        genAppend( b, "%s\"p%d\":%d", ( i > 0 ) ? "," : "", i, i * 7 );
+    }
+
+    genAppend( b, "},\"reported\":{\"firmware\":\"1.4.2\",\"online\":true,\"sensors\":{" );
+
+    for( i = 0; i < 20; i++ )
+    {
+        genAppend( b, "%s\"s%d\":{\"value\":%d.%d,\"unit\":\"C\",\"ok\":true}",
+                   ( i > 0 ) ? "," : "", i, 20 + i, i % 10 );
+    }
+
+    genAppend( b, "}}},\"metadata\":{\"desired\":{" );
+
+    for( i = 0; i < 64; i++ )
+    {
+        genAppend( b, "%s\"p%d\":{\"timestamp\":%d}", ( i > 0 ) ? "," : "", i, 1700000000 + i );
+    }
+
+    genAppend( b, "}},\"version\":4312,\"timestamp\":1700000123}" );
+}
+
+/**
+ * @brief Generate a job execution document.
+ *
+ * @param[out] b  The buffer to receive the document.
+ */
+static void makeJobs( buffer_t * b )
+{
+    int i;
+
+    genAppend( b, "{\"clientToken\":\"a1b2c3d4\",\"execution\":{\"jobId\":\"ota-update-0042\","
+                  "\"status\":\"QUEUED\",\"queuedAt\":1700000000,\"versionNumber\":1,"
+                  "\"executionNumber\":1,\"jobDocument\":{\"operation\":\"update\",\"files\":[" );
+
+    for( i = 0; i < 8; i++ )
+    {
+        genAppend( b, "%s{\"fileName\":\"image-%d.bin\",\"fileSize\":%d,\"fileLocation\":"
+                      "{\"url\":\"https://example.com/firmware/image-%d.bin?X-Amz-Expires=3600\"}}",
+                   ( i > 0 ) ? "," : "", i, 65536 * ( i + 1 ), i );
+    }
+
+    genAppend( b, "],\"parameters\":{" );
+
+    for( i = 0; i < 100; i++ )
+    {
+        genAppend( b, "%s\"k%d\":\"v\\u00e9%d\"", ( i > 0 ) ? "," : "", i, i );
+    }
+
+    genAppend( b, "}}},\"timestamp\":1700000001}" );
+}
+
+/**
+ * @brief Generate a telemetry batch of sensor samples.
+ *
+ * @param[out] b  The buffer to receive the document.
+ */
+static void makeTelemetry( buffer_t * b )
+{
+    int i;
+
+    genAppend( b, "{\"device\":\"sensor-0017\",\"samples\":[" );
+
+    for( i = 0; i < 1000; i++ )
+    {
+        genAppend( b, "%s{\"ts\":%d,\"temp\":%d.%d,\"humidity\":%d,\"battery\":3.%d,"
+                      "\"location\":[47.6%04d,-122.3%04d],\"status\":\"%s\"}",
+                   ( i > 0 ) ? "," : "", 1700000000 + i, 20 + ( i % 5 ), i % 10,
+                   40 + ( i % 20 ), 9 - ( i % 3 ), i, i, ( ( i % 97 ) == 0 ) ? "warn" : "ok" );
+    }
+
+    genAppend( b, "]}" );
+}
+
+static const namedQuery_t shadowQueries[] =
+{
+    { "shallow",   "version"                     },
+    { "deep",      "state.reported.sensors.s19.ok" },
+    { "many-keys", "state.desired.p63"           },
+    { "subtree",   "state.desired"               }
+};
+
+static const namedQuery_t jobsQueries[] =
+{
+    { "shallow",   "timestamp"                                     },
+    { "deep",      "execution.jobDocument.files[7].fileLocation.url" },
+    { "many-keys", "execution.jobDocument.parameters.k99"          }
+};
+
+static const namedQuery_t telemetryQueries[] =
+{
+    { "shallow", "device"              },
+    { "deep",    "samples[999].status" }
+};
+
+/**
+ * @brief Read a monotonic clock.
+ *
+ * @return the time in seconds.
+ */
+static double now( void )
+{
+    struct timespec ts;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ( double ) ts.tv_sec + ( ( double ) ts.tv_nsec / 1e9 );
+}
+
+/**
+ * @brief Run an operation once.
+ *
+ * @param[in] op  The operation.
+ * @param[in] c  The corpus.
+ * @param[in] query  The query for the search operations.
+ *
+ * @return the result of the operation.
+ */
+static JSONStatus_t runOnce( op_t op,
+                             const corpus_t * c,
+                             const char * query )
+{
+    JSONStatus_t result;
+    const char * value;
+    size_t valueLength, start = 0U, next = 0U, indexCount = 0U, count = 0U, i;
+    JSONPair_t pair;
+    JSONCursor_t cursor;
+
+    switch( op )
+    {
+        case opValidate:
+            result = JSON_Validate( c->buf, c->length );
+            break;
+
+        case opSearch:
+            result = JSON_SearchConst( c->buf, c->length, query, strlen( query ),
+                                       &value, &valueLength, NULL );
+            break;
+
+        case opTrustedSearch:
+            result = JSON_SearchTrusted( c->buf, c->length, query, strlen( query ),
+                                         &value, &valueLength, NULL );
+            break;
+
+        case opStartSearch:
+            result = JSON_SearchStart( c->buf, c->length, query, strlen( query ),
+                                       &value, NULL );
+            break;
+
+        case opEachSearch:
+            result = JSON_DocOpen( c->buf, c->length, &cursor );
+
+            if( result == JSONSuccess )
+            {
+                result = JSON_SearchEach( &cursor, query, strlen( query ), countMatch, &count );
+            }
+
+            break;
+
+        case opValidateThenSearch:
+            result = JSON_Validate( c->buf, c->length );
+
+            for( i = 0U; ( result == JSONSuccess ) && ( i < c->queryCount ); i++ )
+            {
+                result = JSON_SearchConst( c->buf, c->length, c->queries[ i ].query,
+                                           strlen( c->queries[ i ].query ),
+                                           &value, &valueLength, NULL );
+            }
+
+            break;
+
+        case opIndexThenSearch:
+            result = JSON_ValidateAndIndex( c->buf, c->length, indexEntries,
+                                            INDEX_CAPACITY, &indexCount );
+
+            for( i = 0U; ( result == JSONSuccess ) && ( i < c->queryCount ); i++ )
+            {
+                result = JSON_SearchIndexed( c->buf, c->length, indexEntries, indexCount,
+                                             c->queries[ i ].query,
+                                             strlen( c->queries[ i ].query ),
+                                             &value, &valueLength, NULL );
+            }
+
+            break;
+
+        default:
+
+            do
+            {
+                result = JSON_Iterate( c->buf, c->length, &start, &next, &pair );
+            } while( result == JSONSuccess );
+
+            /* Reaching the end of the collection is the expected outcome. */
+            if( result == JSONNotFound )
+            {
+                result = JSONSuccess;
+            }
+
+            break;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Print a string as a JSON string, escaping the characters that
+ * cannot appear in one as-is.
+ *
+ * @param[in] s  The string, e.g. a file name or query from the command line.
+ */
+static void printString( const char * s )
+{
+    const char * p;
+
+    putchar( '"' );
+
+    for( p = s; *p != '\0'; p++ )
+    {
+        if( ( *p == '"' ) || ( *p == '\\' ) )
+        {
+            printf( "\\%c", *p );
+        }
+        else if( ( unsigned char ) *p < 0x20U )
+        {
+            printf( "\\u%04x", ( unsigned ) ( unsigned char ) *p );
+        }
+        else
+        {
+            putchar( *p );
+        }
+    }
+
+    putchar( '"' );
+}
+
+/**
+ * @brief Time an operation, and print the result as a JSON object.
+ *
+ * @param[in] op  The operation.
+ * @param[in] label  The name under which to report the operation.
+ * @param[in] c  The corpus.
+ * @param[in] query  The query for the search operations.
+ */
+static void measure( op_t op,
+                     const char * label,
+                     const corpus_t * c,
+                     const char * query )
+{
+    JSONStatus_t result;
+    unsigned long iterations = 0UL, batch = 1UL, i;
+    double start, elapsed = 0.0, nsPerOp, mbPerSecond;
+
+    result = runOnce( op, c, query );
+
+    start = now();
+
+    while( elapsed < minSeconds )
+    {
+        for( i = 0UL; i < batch; i++ )
+        {
+            ( void ) runOnce( op, c, query );
+        }
+
+        iterations += batch;
+        batch *= 2UL;
+        elapsed = now() - start;
+    }
+
+    nsPerOp = ( elapsed * 1e9 ) / ( double ) iterations;
+    mbPerSecond = ( ( double ) c->length * ( double ) iterations ) / ( elapsed * 1e6 );
+
+    printf( "%s\n    {\"corpus\":", firstResult ? "" : "," );
+    printString( c->name );
+    printf( ",\"bytes\":%zu,\"op\":", c->length );
+    printString( label );
+
+    if( query != NULL )
+    {
+        printf( ",\"query\":" );
+        printString( query );
+    }
+
+    printf( ",\"status\":%d,\"iterations\":%lu,\"ns_per_op\":%.1f,\"mb_per_s\":%.2f}",
+            ( int ) result, iterations, nsPerOp, mbPerSecond );
+
+    firstResult = 0;
+}
+
+/**
+ * @brief Measure every operation on a corpus.
+ *
+ * @param[in] c  The corpus.
+ * @param[in] extra  Queries given on the command line.
+ * @param[in] extraCount  The number of queries given on the command line.
+ */
+static void measureCorpus( const corpus_t * c,
+                           const char * const * extra,
+                           size_t extraCount )
+{
+    char label[ 64 ];
+    size_t i;
+
+    measure( opValidate, "validate", c, NULL );
+
+    for( i = 0U; i < c->queryCount; i++ )
+    {
+        ( void ) snprintf( label, sizeof( label ), "search_%s", c->queries[ i ].name );
+        measure( opSearch, label, c, c->queries[ i ].query );
+
+        ( void ) snprintf( label, sizeof( label ), "trusted_search_%s", c->queries[ i ].name );
+        measure( opTrustedSearch, label, c, c->queries[ i ].query );
+
+        ( void ) snprintf( label, sizeof( label ), "start_search_%s", c->queries[ i ].name );
+        measure( opStartSearch, label, c, c->queries[ i ].query );
+    }
+
+    for( i = 0U; i < extraCount; i++ )
+    {
+        measure( opSearch, "search", c, extra[ i ] );
+    }
+
+    if( c->wildcard != NULL )
+    {
+        measure( opEachSearch, "each_search", c, c->wildcard );
+    }
+
+    measure( opIterate, "iterate", c, NULL );
+
+    if( c->queryCount > 0U )
+    {
+        measure( opValidateThenSearch, "validate_then_search", c, NULL );
+        measure( opIndexThenSearch, "index_then_search", c, NULL );
+    }
+}
+
+/**
+ * @brief Read a whole file into memory.
+ *
+ * @param[in] path  The file to read.
+ * @param[out] b  The buffer to receive the contents.
+ *
+ * @return 0 on success; -1 otherwise.
+ */
+static int readFile( const char * path,
+                     buffer_t * b )
+{
+    int ret = -1;
+    FILE * f;
+    long size;
+
+    f = fopen( path, "rb" );
+
+    if( f != NULL )
+    {
+        if( ( fseek( f, 0L, SEEK_END ) == 0 ) && ( ( size = ftell( f ) ) > 0L ) &&
+            ( fseek( f, 0L, SEEK_SET ) == 0 ) )
+        {
+            b->capacity = ( size_t ) size;
+            b->buf = malloc( b->capacity );
+
+            if( ( b->buf != NULL ) &&
+                ( fread( b->buf, 1U, b->capacity, f ) == b->capacity ) )
+            {
+                b->length = b->capacity;
+                ret = 0;
+            }
+        }
+
+        ( void ) fclose( f );
+    }
+
+    if( ret != 0 )
+    {
+        fprintf( stderr, "%s: cannot read file\n", path );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Measure documents from the generator, each stressing one aspect of
+ * the parser: nesting depth, object width, subtree skipping, and strings.
+ */
+static void measureShapes( void )
+{
+    static const struct
+    {
+        const char * name;
+        size_t depth;
+        size_t fanout;
+        size_t branch;
+        size_t stringLength;
+        unsigned escapePercent;
+        unsigned nonAsciiPercent;
+    }
+    shapes[] =
+    {
+        { "gen-deep",    30U, 4U,     1U, 16U, 0U,  0U  },
+        { "gen-wide",    0U,  10000U, 0U, 16U, 0U,  0U  },
+        { "gen-bushy",   4U,  8U,     4U, 16U, 0U,  0U  },
+        { "gen-strings", 1U,  256U,   1U, 64U, 10U, 10U }
+    };
+    genParams_t p;
+    buffer_t b, q;
+    namedQuery_t deepest;
+    corpus_t c;
+    size_t i;
+
+    for( i = 0U; i < ( sizeof( shapes ) / sizeof( shapes[ 0 ] ) ); i++ )
+    {
+        genDefaults( &p );
+        p.depth = shapes[ i ].depth;
+        p.fanout = shapes[ i ].fanout;
+        p.branch = shapes[ i ].branch;
+        p.keyLength = 6U;
+        p.stringLength = shapes[ i ].stringLength;
+        p.escapePercent = shapes[ i ].escapePercent;
+        p.nonAsciiPercent = shapes[ i ].nonAsciiPercent;
+
+        memset( &b, 0, sizeof( b ) );
+        memset( &q, 0, sizeof( q ) );
+        genDocument( &p, &b, &q );
+
+        deepest.name = "deepest";
+        deepest.query = q.buf;
+
+        c.name = shapes[ i ].name;
+        c.buf = b.buf;
+        c.length = b.length;
+        c.queries = &deepest;
+        c.queryCount = 1U;
+        c.wildcard = NULL;
+        measureCorpus( &c, NULL, 0U );
+
+        free( b.buf );
+        free( q.buf );
+    }
+}
+
+int main( int argc,
+          char ** argv )
+{
+    int ret = 0;
+    int i;
+    size_t g;
+    buffer_t b;
+    corpus_t c;
+    const char * queries[ MAX_QUERIES ];
+    size_t queryCount = 0U;
+    const struct
+    {
+        const char * name;
+        void ( * make )( buffer_t * b );
+        const namedQuery_t * queries;
+        size_t queryCount;
+        const char * wildcard;
+    }
+    generated[] =
+    {
+        { "shadow",    makeShadow,    shadowQueries,    sizeof( shadowQueries ) / sizeof( shadowQueries[ 0 ] ),       NULL                                              },
+        { "jobs",      makeJobs,      jobsQueries,      sizeof( jobsQueries ) / sizeof( jobsQueries[ 0 ] ),           "execution.jobDocument.files[*].fileLocation.url" },
+        { "telemetry", makeTelemetry, telemetryQueries, sizeof( telemetryQueries ) / sizeof( telemetryQueries[ 0 ] ), "samples[*].status"                               }
+    };
+
+    for( i = 1; ( i < argc ) && ( argv[ i ][ 0 ] == '-' ); i += 2 )
+    {
+        if( ( i + 1 ) >= argc )
+        {
+            ret = 2;
+        }
+        else if( strcmp( argv[ i ], "-t" ) == 0 )
+        {
+            minSeconds = atof( argv[ i + 1 ] );
+        }
+        else if( ( strcmp( argv[ i ], "-q" ) == 0 ) && ( queryCount < MAX_QUERIES ) )
+        {
+            queries[ queryCount ] = argv[ i + 1 ];
+            queryCount++;
+        }
+        else
+        {
+            ret = 2;
+        }
+
+        if( ret != 0 )
+        {
+            fprintf( stderr, "usage: %s [-t SECONDS] [-q QUERY]... [FILE...]\n", argv[ 0 ] );
+            break;
+        }
+    }
+
+    if( ret == 0 )
+    {
+        printf( "{\"min_seconds\":%g,\"results\":[", minSeconds );
+
+        for( g = 0U; g < ( sizeof( generated ) / sizeof( generated[ 0 ] ) ); g++ )
+        {
+            memset( &b, 0, sizeof( b ) );
+            generated[ g ].make( &b );
+
+            c.name = generated[ g ].name;
+            c.buf = b.buf;
+            c.length = b.length;
+            c.queries = generated[ g ].queries;
+            c.queryCount = generated[ g ].queryCount;
+            c.wildcard = generated[ g ].wildcard;
+            measureCorpus( &c, NULL, 0U );
+
+            free( b.buf );
+        }
+
+        measureShapes();
+
+        for( ; i < argc; i++ )
+        {
+            memset( &b, 0, sizeof( b ) );
+
+            if( readFile( argv[ i ], &b ) != 0 )
+            {
+                ret = 1;
+            }
+            else
+            {
+                c.name = argv[ i ];
+                c.buf = b.buf;
+                c.length = b.length;
+                c.queries = NULL;
+                c.queryCount = 0U;
+                c.wildcard = NULL;
+                measureCorpus( &c, queries, queryCount );
+            }
+
+            free( b.buf );
+        }
+
+        printf( "\n]}\n" );
+    }
+
+    return ret;
+}
@@ -0,0 +1,158 @@
+/*
+ * coreJSON
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file corejson_gen.c
+ * @brief Writes a synthetic JSON document of a controlled shape to stdout.
+ *
+ * Output is reproducible for a given seed, so the cost of validating or
+ * searching a document can be studied along one parameter at a time.
+ * A JSON_Search() query for the most deeply nested value is written to
+ * stderr.
+ *
+ * Usage:
+ *     corejson-gen [--seed N] [--depth N] [--fanout N] [--branch N]
+ *                  [--key-length N] [--string-length N] [--escapes PERCENT]
+ *                  [--non-ascii PERCENT] [--numbers int|frac|exp] [--arrays]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "generator.h"
+
+/**
+ * @brief Set a parameter from a command-line option.
+ *
+ * @param[in,out] p  The parameters.
+ * @param[in] name  The option name.
+ * @param[in] value  The option value.
+ *
+ * @return 0 on success; -1 if the option is unknown.
+ */
+static int setOption( genParams_t * p,
+                      const char * name,
+                      const char * value )
+{
+    int ret = 0;
+    size_t n = ( size_t ) strtoul( value, NULL, 10 );
+
+    if( strcmp( name, "--seed" ) == 0 )
+    {
+        p->seed = ( uint32_t ) n;
+    }
+    else if( strcmp( name, "--depth" ) == 0 )
+    {
+        p->depth = n;
+    }
+    else if( strcmp( name, "--fanout" ) == 0 )
+    {
+        p->fanout = n;
+    }
+    else if( strcmp( name, "--branch" ) == 0 )
+    {
+        p->branch = n;
+    }
+    else if( strcmp( name, "--key-length" ) == 0 )
+    {
+        p->keyLength = n;
+    }
+    else if( strcmp( name, "--string-length" ) == 0 )
+    {
+        p->stringLength = n;
+    }
+    else if( strcmp( name, "--escapes" ) == 0 )
+    {
+        p->escapePercent = ( unsigned ) n;
+    }
+    else if( strcmp( name, "--non-ascii" ) == 0 )
+    {
+        p->nonAsciiPercent = ( unsigned ) n;
+    }
+    else if( strcmp( name, "--numbers" ) == 0 )
+    {
+        p->numberShape = ( strcmp( value, "exp" ) == 0 ) ? numberExponent :
+                         ( strcmp( value, "frac" ) == 0 ) ? numberFraction : numberInteger;
+    }
+    else
+    {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+int main( int argc,
+          char ** argv )
+{
+    int ret = 0;
+    int i;
+    genParams_t p;
+    buffer_t doc = { NULL, 0U, 0U };
+    buffer_t query = { NULL, 0U, 0U };
+
+    genDefaults( &p );
+
+    for( i = 1; ( i < argc ) && ( ret == 0 ); i++ )
+    {
+        if( strcmp( argv[ i ], "--arrays" ) == 0 )
+        {
+            p.arrays = 1;
+        }
+        else if( ( ( i + 1 ) >= argc ) || ( setOption( &p, argv[ i ], argv[ i + 1 ] ) != 0 ) )
+        {
+            ret = 2;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if( ( ret == 0 ) && ( p.fanout == 0U ) )
+    {
+        ret = 2;
+    }
+
+    if( ret != 0 )
+    {
+        fprintf( stderr,
+                 "usage: %s [--seed N] [--depth N] [--fanout N] [--branch N]\n"
+                 "       [--key-length N] [--string-length N] [--escapes PERCENT]\n"
+                 "       [--non-ascii PERCENT] [--numbers int|frac|exp] [--arrays]\n",
+                 argv[ 0 ] );
+    }
+    else
+    {
+        genDocument( &p, &doc, &query );
+        ( void ) fwrite( doc.buf, 1U, doc.length, stdout );
+        fprintf( stderr, "%.*s\n", ( int ) query.length, query.buf );
+    }
+
+    free( doc.buf );
+    free( query.buf );
+
+    return ret;
+}
@@ -0,0 +1,288 @@
+/*
+ * coreJSON
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file generator.c
+ * @brief Generates synthetic JSON documents of a controlled shape.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "generator.h"
+
+/**
+ * @brief Return the next value of a xorshift32 generator.
+ *
+ * @param[in,out] state  The generator state; must not be 0.
+ *
+ * @return a pseudo-random value.
+ */
+static uint32_t nextRandom( uint32_t * state )
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+/**
+ * @brief Return true with the given probability.
+ *
+ * @param[in,out] state  The generator state.
+ * @param[in] percent  The probability, in percent.
+ *
+ * @return non-zero with the given probability.
+ */
+static int chance( uint32_t * state,
+                   unsigned percent )
+{
+    return ( nextRandom( state ) % 100U ) < percent;
+}
+
+void genDefaults( genParams_t * p )
+{
+    p->seed = 1U;
+    p->depth = 4U;
+    p->fanout = 8U;
+    p->branch = 1U;
+    p->keyLength = 4U;
+    p->stringLength = 16U;
+    p->escapePercent = 0U;
+    p->nonAsciiPercent = 0U;
+    p->numberShape = numberInteger;
+    p->arrays = 0;
+}
+
+void genAppend( buffer_t * b,
+                const char * fmt,
+                ... )
+{
+    va_list ap;
+    int n;
+
+    va_start( ap, fmt );
+    n = vsnprintf( NULL, 0, fmt, ap );
+    va_end( ap );
+
+    if( ( b->length + ( size_t ) n + 1U ) > b->capacity )
+    {
+        b->capacity = ( b->capacity * 2U ) + ( size_t ) n + 1U;
+        b->buf = realloc( b->buf, b->capacity );
+
+        if( b->buf == NULL )
+        {
+            fprintf( stderr, "out of memory\n" );
+            exit( 1 );
+        }
+    }
+
+    va_start( ap, fmt );
+    ( void ) vsnprintf( &b->buf[ b->length ], ( size_t ) n + 1U, fmt, ap );
+    va_end( ap );
+
+    b->length += ( size_t ) n;
+}
+
+/**
+ * @brief Append a string value.
+ *
+ * @param[in] p  The parameters.
+ * @param[in,out] state  The generator state.
+ * @param[out] b  The buffer.
+ */
+static void genString( const genParams_t * p,
+                       uint32_t * state,
+                       buffer_t * b )
+{
+    static const char * const escapes[] =
+    {
+        "\\n", "\\t", "\\\"", "\\\\", "\\/", "\\u00e9", "\\ud83d\\ude00"
+    };
+    static const char * const nonAscii[] =
+    {
+        "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80"
+    };
+    size_t i;
+
+    genAppend( b, "\"" );
+
+    for( i = 0U; i < p->stringLength; i++ )
+    {
+        if( chance( state, p->escapePercent ) )
+        {
+            genAppend( b, "%s", escapes[ nextRandom( state ) % 7U ] );
+        }
+        else if( chance( state, p->nonAsciiPercent ) )
+        {
+            genAppend( b, "%s", nonAscii[ nextRandom( state ) % 3U ] );
+        }
+        else
+        {
+            genAppend( b, "%c", ( char ) ( 'a' + ( nextRandom( state ) % 26U ) ) );
+        }
+    }
+
+    genAppend( b, "\"" );
+}
+
+/**
+ * @brief Append a number value.
+ *
+ * @param[in] p  The parameters.
+ * @param[in,out] state  The generator state.
+ * @param[out] b  The buffer.
+ */
+static void genNumber( const genParams_t * p,
+                       uint32_t * state,
+                       buffer_t * b )
+{
+    long whole = ( long ) ( nextRandom( state ) % 2000000U ) - 1000000L;
+
+    switch( p->numberShape )
+    {
+        case numberFraction:
+            genAppend( b, "%ld.%03u", whole, nextRandom( state ) % 1000U );
+            break;
+
+        case numberExponent:
+            genAppend( b, "%ld.%ue%+d", whole % 10L, nextRandom( state ) % 1000U,
+                       ( int ) ( nextRandom( state ) % 61U ) - 30 );
+            break;
+
+        default:
+            genAppend( b, "%ld", whole );
+            break;
+    }
+}
+
+/**
+ * @brief Append a scalar value, cycling through the scalar types.
+ *
+ * @param[in] p  The parameters.
+ * @param[in,out] state  The generator state.
+ * @param[in] index  The position of the value in its collection.
+ * @param[out] b  The buffer.
+ */
+static void genScalar( const genParams_t * p,
+                       uint32_t * state,
+                       size_t index,
+                       buffer_t * b )
+{
+    switch( index % 4U )
+    {
+        case 0:
+            genString( p, state, b );
+            break;
+
+        case 1:
+            genNumber( p, state, b );
+            break;
+
+        case 2:
+            genAppend( b, ( ( index % 8U ) == 2U ) ? "true" : "false" );
+            break;
+
+        default:
+            genAppend( b, "null" );
+            break;
+    }
+}
+
+/**
+ * @brief Append a collection and its nested collections.
+ *
+ * @param[in] p  The parameters.
+ * @param[in,out] state  The generator state.
+ * @param[in] level  The nesting level of the collection, 0 for the root.
+ * @param[out] b  The buffer.
+ * @param[out] query  If not NULL, receives the path to the last value of the
+ * most deeply nested collection.
+ */
+static void genCollection( const genParams_t * p,
+                           uint32_t * state,
+                           size_t level,
+                           buffer_t * b,
+                           buffer_t * query )
+{
+    size_t i, firstNested;
+
+    firstNested = ( p->fanout > p->branch ) ? ( p->fanout - p->branch ) : 0U;
+
+    genAppend( b, p->arrays ? "[" : "{" );
+
+    for( i = 0U; i < p->fanout; i++ )
+    {
+        int last = ( i + 1U ) == p->fanout;
+        buffer_t * q = last ? query : NULL;
+
+        if( i > 0U )
+        {
+            genAppend( b, "," );
+        }
+
+        if( p->arrays )
+        {
+            if( q != NULL )
+            {
+                genAppend( q, "[%zu]", i );
+            }
+        }
+        else
+        {
+            genAppend( b, "\"k%0*zu\":", ( int ) ( ( p->keyLength > 1U ) ? ( p->keyLength - 1U ) : 1U ), i );
+
+            if( q != NULL )
+            {
+                genAppend( q, "%sk%0*zu", ( level > 0U ) ? "." : "",
+                           ( int ) ( ( p->keyLength > 1U ) ? ( p->keyLength - 1U ) : 1U ), i );
+            }
+        }
+
+        if( ( i >= firstNested ) && ( level < p->depth ) )
+        {
+            genCollection( p, state, level + 1U, b, q );
+        }
+        else
+        {
+            genScalar( p, state, i, b );
+        }
+    }
+
+    genAppend( b, p->arrays ? "]" : "}" );
+}
+
+void genDocument( const genParams_t * p,
+                  buffer_t * doc,
+                  buffer_t * query )
+{
+    uint32_t state = ( p->seed != 0U ) ? p->seed : 1U;
+
+    genCollection( p, &state, 0U, doc, query );
+}
@@ -0,0 +1,109 @@
+/*
+ * coreJSON
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file generator.h
+ * @brief Generates synthetic JSON documents of a controlled shape.
+ */
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A growable buffer holding generated text.
+ */
+typedef struct
+{
+    char * buf;
+    size_t length;
+    size_t capacity;
+} buffer_t;
+
+/**
+ * @brief The form of generated numbers.
+ */
+typedef enum
+{
+    numberInteger,  /**< @brief e.g. -1234 */
+    numberFraction, /**< @brief e.g. -12.345 */
+    numberExponent  /**< @brief e.g. -1.5e+12 */
+} numberShape_t;
+
+/**
+ * @brief Parameters of a generated document.
+ *
+ * The root is a collection of fanout members.  In each collection, the last
+ * branch members are nested collections, down to the given depth; the others
+ * are scalars.  The document size is therefore about fanout * branch^depth
+ * values.
+ */
+typedef struct
+{
+    uint32_t seed;             /**< @brief Seed, so output is reproducible. */
+    size_t depth;              /**< @brief Levels of nested collections below the root. */
+    size_t fanout;             /**< @brief Members in each collection. */
+    size_t branch;             /**< @brief Nested collections in each collection. */
+    size_t keyLength;          /**< @brief Minimum length of object keys. */
+    size_t stringLength;       /**< @brief Characters in each string value. */
+    unsigned escapePercent;    /**< @brief Share of string characters that are escapes. */
+    unsigned nonAsciiPercent;  /**< @brief Share of string characters that are non-ASCII. */
+    numberShape_t numberShape; /**< @brief Form of number values. */
+    int arrays;                /**< @brief Non-zero for arrays rather than objects. */
+} genParams_t;
+
+/**
+ * @brief Set parameters to their defaults.
+ *
+ * @param[out] p  The parameters.
+ */
+void genDefaults( genParams_t * p );
+
+/**
+ * @brief Append formatted text to a buffer, growing it as needed.
+ *
+ * Exits the program if memory is exhausted.
+ *
+ * @param[in] b  The buffer.
+ * @param[in] fmt  The printf format.
+ */
+void genAppend( buffer_t * b,
+                const char * fmt,
+                ... );
+
+/**
+ * @brief Generate a document.
+ *
+ * @param[in] p  The parameters.
+ * @param[out] doc  The buffer to receive the document.
+ * @param[out] query  If not NULL, receives a JSON_Search() query for the last
+ * value of the most deeply nested collection.
+ */
+void genDocument( const genParams_t * p,
+                  buffer_t * doc,
+                  buffer_t * query );
+
+#endif /* ifndef GENERATOR_H_ */
@@ -32,6 +32,10 @@
 #include <stdint.h>
 #include "core_json.h"
 
+#ifdef JSON_ENABLE_SDT_PROBES
+    #include <sys/sdt.h>
+#endif
+
 /** @cond DO_NOT_DOCUMENT */
 
 /* A compromise to satisfy both MISRA and CBMC */
@@ -46,7 +50,9 @@ typedef union
 #else
     #define isascii_( x )    ( ( x ) >= '\0' )
 #endif
-#define iscntrl_( x )        ( isascii_( x ) && ( ( x ) < ' ' ) )
+#define isPlainStringChar_( x )              \
+    ( isascii_( x ) && ( ( x ) >= ' ' ) && \
+      ( ( x ) != '"' ) && ( ( x ) != '\\' ) )
 #define isdigit_( x )        ( ( ( x ) >= '0' ) && ( ( x ) <= '9' ) )
 /* NB. This is whitespace as defined by the JSON standard (ECMA-404). */
 #define isspace_( x )                          \
@@ -63,6 +69,80 @@ typedef union
 #define isCurlyOpen_( x )             ( ( x ) == '{' )
 #define isCurlyClose_( x )            ( ( x ) == '}' )
 
+#ifdef JSON_ENABLE_STATS
+
+/**
+ * @brief Qualifier of the pointer to the attached counters.
+ *
+ * Define as a thread-local storage class, e.g. _Thread_local, so each
+ * thread may attach its own counters with JSON_SetStats().
+ */
+    #ifndef JSON_STATS_THREAD_LOCAL
+        #define JSON_STATS_THREAD_LOCAL
+    #endif
+
+/**
+ * @brief The counters attached with JSON_SetStats(), or NULL.
+ */
+    static JSON_STATS_THREAD_LOCAL JSONStats_t * statsTarget = NULL;
+
+    #define statsAdd_( field, n )                       \
+    do {                                                \
+        if( statsTarget != NULL )                       \
+        {                                               \
+            statsTarget->field += ( n );                \
+        }                                               \
+    } while( 0 )
+
+    #define statsScanned_( n )                          \
+    do {                                                \
+        if( statsTarget != NULL )                       \
+        {                                               \
+            statsTarget->bytesScanned += ( n );         \
+            statsTarget->queryBytesScanned += ( n );    \
+        }                                               \
+    } while( 0 )
+
+    #define statsQuery_( max )                          \
+    do {                                                \
+        if( statsTarget != NULL )                       \
+        {                                               \
+            statsTarget->queries++;                     \
+            statsTarget->queryBytesScanned = 0U;        \
+            statsTarget->queryDocumentLength = ( max ); \
+        }                                               \
+    } while( 0 )
+#else /* ifdef JSON_ENABLE_STATS */
+    #define statsAdd_( field, n )    ( ( void ) 0 )
+    #define statsScanned_( n )       ( ( void ) 0 )
+    #define statsQuery_( max )       ( ( void ) 0 )
+#endif /* ifdef JSON_ENABLE_STATS */
+
+/**
+ * @brief Static tracepoints at the entry and return of the public functions.
+ *
+ * When built with JSON_ENABLE_SDT_PROBES, these are USDT probes of the
+ * provider "corejson", e.g. corejson:validate__entry, for use with tools
+ * such as bpftrace and perf.  A probe costs a single no-op instruction
+ * while it is not enabled.  Otherwise, no code is generated.
+ *
+ * JSON_SearchT() and JSON_Search() fire the probes of JSON_SearchConst().
+ * The return probes carry the buffer length, the status, and the index
+ * at which the call stopped reading: the end of the document for
+ * JSON_Validate(); for JSON_SearchConst(), the end of the value found,
+ * including the closing quote of a string, or else the member or element
+ * at which the search gave up; and the next index for JSON_Iterate().
+ */
+#ifdef JSON_ENABLE_SDT_PROBES
+    #define traceProbe2_( name, a, b )          DTRACE_PROBE2( corejson, name, a, b )
+    #define traceProbe3_( name, a, b, c )       DTRACE_PROBE3( corejson, name, a, b, c )
+    #define traceProbe4_( name, a, b, c, d )    DTRACE_PROBE4( corejson, name, a, b, c, d )
+#else
+    #define traceProbe2_( name, a, b )          ( ( void ) 0 )
+    #define traceProbe3_( name, a, b, c )       ( ( void ) 0 )
+    #define traceProbe4_( name, a, b, c, d )    ( ( void ) 0 )
+#endif
+
 /**
  * @brief Advance buffer index beyond whitespace.
  *
@@ -232,6 +312,7 @@ static bool skipUTF8MultiByte( const char * buf,
 
         if( ( j == 0U ) && ( shortestUTF8( bitCount, value ) == true ) )
         {
+            statsAdd_( utf8Skipped, 1U );
             *start = i + 1U;
             ret = true;
         }
@@ -473,6 +554,7 @@ static bool skipEscape( const char * buf,
 
     if( ret == true )
     {
+        statsAdd_( escapesSkipped, 1U );
         *start = i;
     }
 
@@ -506,22 +588,27 @@ static bool skipString( const char * buf,
 
         while( i < max )
         {
-            if( buf[ i ] == '"' )
+            /* Test for the common case first, so most bytes take one branch. */
+            if( isPlainStringChar_( buf[ i ] ) )
+            {
+                i++;
+            }
+            else if( buf[ i ] == '"' )
             {
                 ret = true;
                 i++;
                 break;
             }
-
-            if( buf[ i ] == '\\' )
+            else if( buf[ i ] == '\\' )
             {
                 if( skipEscape( buf, &i, max ) != true )
                 {
                     break;
                 }
             }
-            /* An unescaped control character is not allowed. */
-            else if( iscntrl_( buf[ i ] ) )
+            /* The remaining ASCII characters are unescaped control
+             * characters, which are not allowed. */
+            else if( isascii_( buf[ i ] ) )
             {
                 break;
             }
@@ -538,6 +625,7 @@ static bool skipString( const char * buf,
 
     if( ret == true )
     {
+        statsAdd_( stringsSkipped, 1U );
         *start = i;
     }
 
@@ -1077,6 +1165,73 @@ static bool skipScalars( const char * buf,
     return ret;
 }
 
+/**
+ * @brief State of a structural index being written.
+ *
+ * Entries beyond the capacity are dropped, but still counted,
+ * so that the size required may be reported to the caller.
+ */
+typedef struct
+{
+    JSONIndexEntry_t * entries;
+    size_t capacity;
+    size_t count;
+} indexWriter_t;
+
+/**
+ * @brief Add an entry for an opening bracket to an index.
+ *
+ * @param[in,out] index  The index to write, or NULL.
+ * @param[in] open  The index of the opening bracket.
+ */
+static void indexOpen( indexWriter_t * index,
+                       size_t open )
+{
+    if( index != NULL )
+    {
+        if( index->count < index->capacity )
+        {
+            index->entries[ index->count ].open = open;
+            index->entries[ index->count ].close = 0U;
+        }
+
+        index->count++;
+    }
+}
+
+/**
+ * @brief Record a closing bracket in an index.
+ *
+ * The collection being closed is the last entry not yet closed.  Entries
+ * after it are its descendants, so each entry is passed over at most once
+ * per enclosing collection.
+ *
+ * @param[in,out] index  The index to write, or NULL.
+ * @param[in] close  The index of the closing bracket.
+ */
+static void indexClose( indexWriter_t * index,
+                        size_t close )
+{
+    size_t n = 0U;
+
+    /* Once entries have been dropped, the index is incomplete anyway. */
+    if( ( index != NULL ) && ( index->count <= index->capacity ) )
+    {
+        n = index->count;
+
+        while( n > 0U )
+        {
+            n--;
+
+            if( index->entries[ n ].close == 0U )
+            {
+                index->entries[ n ].close = close;
+                break;
+            }
+        }
+    }
+}
+
 /**
  * @brief Advance buffer index beyond a collection and handle nesting.
  *
@@ -1086,6 +1241,8 @@ static bool skipScalars( const char * buf,
  * @param[in] buf  The buffer to parse.
  * @param[in,out] start  The index at which to begin.
  * @param[in] max  The size of the buffer.
+ * @param[in,out] index  An index to receive the position of each
+ * collection, or NULL.
  *
  * @return #JSONSuccess if the buffer contents are a valid JSON collection;
  * #JSONIllegalDocument if the buffer contents are NOT valid JSON;
@@ -1095,9 +1252,10 @@ static bool skipScalars( const char * buf,
 #ifndef JSON_MAX_DEPTH
     #define JSON_MAX_DEPTH    32
 #endif
-static JSONStatus_t skipCollection( const char * buf,
-                                    size_t * start,
-                                    size_t max )
+static JSONStatus_t indexCollection( const char * buf,
+                                     size_t * start,
+                                     size_t max,
+                                     indexWriter_t * index )
 {
     JSONStatus_t ret = JSONPartial;
     char c, stack[ JSON_MAX_DEPTH ];
@@ -1126,6 +1284,8 @@ static JSONStatus_t skipCollection( const char * buf,
                 }
 
                 stack[ depth ] = c;
+                statsAdd_( collectionsSkipped, 1U );
+                indexOpen( index, i - 1U );
 
                 if( skipScalars( buf, &i, max, stack[ depth ] ) != true )
                 {
@@ -1137,6 +1297,9 @@ static JSONStatus_t skipCollection( const char * buf,
             case '}':
             case ']':
 
+                /* Should the bracket not match, the index is not used. */
+                indexClose( index, i - 1U );
+
                 if( ( depth > 0 ) && ( depth < JSON_MAX_DEPTH ) &&
                     isMatchingBracket_( stack[ depth ], c ) )
                 {
@@ -1185,6 +1348,95 @@ static JSONStatus_t skipCollection( const char * buf,
     return ret;
 }
 
+/**
+ * @brief Advance buffer index beyond a collection and handle nesting.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ *
+ * @return Same as indexCollection().
+ */
+static JSONStatus_t skipCollection( const char * buf,
+                                    size_t * start,
+                                    size_t max )
+{
+    return indexCollection( buf, start, max, NULL );
+}
+
+/**
+ * @brief Skip a scalar or collection, after optional leading whitespace.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ * @param[in,out] index  An index to receive the position of each
+ * collection, or NULL.
+ *
+ * @return #JSONSuccess if the value is valid;
+ * #JSONPartial if the buffer ends before the value does;
+ * #JSONIllegalDocument if the value is invalid;
+ * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold.
+ */
+static JSONStatus_t indexValue( const char * buf,
+                                size_t * start,
+                                size_t max,
+                                indexWriter_t * index )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+
+    i = *start;
+    skipSpace( buf, &i, max );
+
+    /** @cond DO_NOT_DOCUMENT */
+    #ifndef JSON_VALIDATE_COLLECTIONS_ONLY
+        if( skipAnyScalar( buf, &i, max ) == true )
+        {
+            ret = JSONSuccess;
+        }
+        else
+    #endif
+    /** @endcond */
+    {
+        /* Keep the unindexed path on skipCollection(), whose contract the proofs use. */
+        if( index == NULL )
+        {
+            ret = skipCollection( buf, &i, max );
+        }
+        else
+        {
+            ret = indexCollection( buf, &i, max, index );
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        statsScanned_( i - *start );
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Skip a scalar or collection, after optional leading whitespace.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ *
+ * @return Same as indexValue().
+ */
+static JSONStatus_t skipValue( const char * buf,
+                               size_t * start,
+                               size_t max )
+{
+    return indexValue( buf, start, max, NULL );
+}
+
 /** @endcond */
 
 /**
@@ -1199,6 +1451,8 @@ JSONStatus_t JSON_Validate( const char * buf,
     JSONStatus_t ret;
     size_t i = 0U;
 
+    traceProbe2_( validate__entry, buf, max );
+
     if( buf == NULL )
     {
         ret = JSONNullParameter;
@@ -1209,20 +1463,7 @@ JSONStatus_t JSON_Validate( const char * buf,
     }
     else
     {
-        skipSpace( buf, &i, max );
-
-        /** @cond DO_NOT_DOCUMENT */
-        #ifndef JSON_VALIDATE_COLLECTIONS_ONLY
-            if( skipAnyScalar( buf, &i, max ) == true )
-            {
-                ret = JSONSuccess;
-            }
-            else
-        #endif
-        /** @endcond */
-        {
-            ret = skipCollection( buf, &i, max );
-        }
+        ret = skipValue( buf, &i, max );
     }
 
     if( ( ret == JSONSuccess ) && ( i < max ) )
@@ -1235,6 +1476,8 @@ JSONStatus_t JSON_Validate( const char * buf,
         }
     }
 
+    traceProbe3_( validate__return, max, ret, i );
+
     return ret;
 }
 
@@ -1288,6 +1531,8 @@ static bool nextValue( const char * buf,
 
     if( ret == true )
     {
+        statsAdd_( valuesScanned, 1U );
+        statsScanned_( i - *start );
         *start = i;
     }
 
@@ -1295,42 +1540,35 @@ static bool nextValue( const char * buf,
 }
 
 /**
- * @brief Output indexes for the next key-value pair of an object.
- *
- * Also advances the buffer index beyond the key-value pair.
- * The value may be a scalar or a collection.
+ * @brief Advance buffer index beyond a key and the colon that follows it.
  *
  * @param[in] buf  The buffer to parse.
  * @param[in,out] start  The index at which to begin.
  * @param[in] max  The size of the buffer.
  * @param[out] key  A pointer to receive the index of the key.
  * @param[out] keyLength  A pointer to receive the length of the key.
- * @param[out] value  A pointer to receive the index of the value.
- * @param[out] valueLength  A pointer to receive the length of the value.
  *
- * @return true if a key-value pair was present;
+ * @return true if a key and colon were present;
  * false otherwise.
  */
-static bool nextKeyValuePair( const char * buf,
-                              size_t * start,
-                              size_t max,
-                              size_t * key,
-                              size_t * keyLength,
-                              size_t * value,
-                              size_t * valueLength )
+static bool nextKey( const char * buf,
+                     size_t * start,
+                     size_t max,
+                     size_t * key,
+                     size_t * keyLength )
 {
     bool ret = true;
     size_t i = 0U, keyStart = 0U;
 
     coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
     coreJSON_ASSERT( ( key != NULL ) && ( keyLength != NULL ) );
-    coreJSON_ASSERT( ( value != NULL ) && ( valueLength != NULL ) );
 
     i = *start;
     keyStart = i;
 
     if( skipString( buf, &i, max ) == true )
     {
+        statsScanned_( i - keyStart );
         *key = keyStart + 1U;
         *keyLength = i - keyStart - 2U;
     }
@@ -1354,6 +1592,49 @@ static bool nextKeyValuePair( const char * buf,
         }
     }
 
+    if( ret == true )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Output indexes for the next key-value pair of an object.
+ *
+ * Also advances the buffer index beyond the key-value pair.
+ * The value may be a scalar or a collection.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ * @param[out] key  A pointer to receive the index of the key.
+ * @param[out] keyLength  A pointer to receive the length of the key.
+ * @param[out] value  A pointer to receive the index of the value.
+ * @param[out] valueLength  A pointer to receive the length of the value.
+ *
+ * @return true if a key-value pair was present;
+ * false otherwise.
+ */
+static bool nextKeyValuePair( const char * buf,
+                              size_t * start,
+                              size_t max,
+                              size_t * key,
+                              size_t * keyLength,
+                              size_t * value,
+                              size_t * valueLength )
+{
+    bool ret = true;
+    size_t i = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+    coreJSON_ASSERT( ( key != NULL ) && ( keyLength != NULL ) );
+    coreJSON_ASSERT( ( value != NULL ) && ( valueLength != NULL ) );
+
+    i = *start;
+    ret = nextKey( buf, &i, max, key, keyLength );
+
     if( ret == true )
     {
         ret = nextValue( buf, &i, max, value, valueLength );
@@ -1374,8 +1655,10 @@ static bool nextKeyValuePair( const char * buf,
  * @param[in] max  size of the buffer.
  * @param[in] query  The object keys and array indexes to search for.
  * @param[in] queryLength  Length of the key.
- * @param[out] outValue  A pointer to receive the index of the value found.
- * @param[out] outValueLength  A pointer to receive the length of the value found.
+ * @param[out] outValue  A pointer to receive the index of the value found,
+ * or the index at which the search stopped.
+ * @param[out] outValueLength  A pointer to receive the length of the value
+ * found, or 0.
  *
  * Iterate over the key-value pairs of an object, looking for a matching key.
  *
@@ -1432,6 +1715,11 @@ static bool objectSearch( const char * buf,
         *outValue = value;
         *outValueLength = valueLength;
     }
+    else
+    {
+        *outValue = i;
+        *outValueLength = 0U;
+    }
 
     return ret;
 }
@@ -1442,8 +1730,10 @@ static bool objectSearch( const char * buf,
  * @param[in] buf  The buffer to search.
  * @param[in] max  size of the buffer.
  * @param[in] queryIndex  The index to search for.
- * @param[out] outValue  A pointer to receive the index of the value found.
- * @param[out] outValueLength  A pointer to receive the length of the value found.
+ * @param[out] outValue  A pointer to receive the index of the value found,
+ * or the index at which the search stopped.
+ * @param[out] outValueLength  A pointer to receive the length of the value
+ * found, or 0.
  *
  * Iterate over the values of an array, looking for a matching index.
  *
@@ -1500,6 +1790,11 @@ static bool arraySearch( const char * buf,
         *outValue = value;
         *outValueLength = valueLength;
     }
+    else
+    {
+        *outValue = i;
+        *outValueLength = 0U;
+    }
 
     return ret;
 }
@@ -1559,8 +1854,10 @@ static bool skipQueryPart( const char * buf,
  * @param[in] max  size of the buffer.
  * @param[in] query  The object keys and array indexes to search for.
  * @param[in] queryLength  Length of the key.
- * @param[out] outValue  A pointer to receive the index of the value found.
- * @param[out] outValueLength  A pointer to receive the length of the value found.
+ * @param[out] outValue  A pointer to receive the index of the value found,
+ * or the index at which the search stopped.
+ * @param[out] outValueLength  A pointer to receive the length of the value
+ * found, or 0.
  *
  * @return #JSONSuccess if the query is matched and the value output;
  * #JSONBadParameter if the query is empty, or any part is empty,
@@ -1577,7 +1874,7 @@ static JSONStatus_t multiSearch( const char * buf,
                                  size_t * outValueLength )
 {
     JSONStatus_t ret = JSONSuccess;
-    size_t i = 0U, start = 0U, queryStart = 0U, value = 0U, length = max;
+    size_t i = 0U, start = 0U, queryStart = 0U, value = 0U, length = max, scan = 0U;
 
     coreJSON_ASSERT( ( buf != NULL ) && ( query != NULL ) );
     coreJSON_ASSERT( ( outValue != NULL ) && ( outValueLength != NULL ) );
@@ -1624,11 +1921,13 @@ static JSONStatus_t multiSearch( const char * buf,
 
         if( found == false )
         {
+            scan = start + value;
             ret = JSONNotFound;
             break;
         }
 
         start += value;
+        scan = start + length;
 
         if( ( i < queryLength ) && isSeparator_( query[ i ] ) )
         {
@@ -1641,6 +1940,11 @@ static JSONStatus_t multiSearch( const char * buf,
         *outValue = start;
         *outValueLength = length;
     }
+    else
+    {
+        *outValue = scan;
+        *outValueLength = 0U;
+    }
 
     return ret;
 }
@@ -1705,7 +2009,9 @@ JSONStatus_t JSON_SearchConst( const char * buf,
                                JSONTypes_t * outType )
 {
     JSONStatus_t ret;
-    size_t value = 0U;
+    size_t value = 0U, length = 0U;
+
+    traceProbe4_( search__entry, buf, max, query, queryLength );
 
     if( ( buf == NULL ) || ( query == NULL ) ||
         ( outValue == NULL ) || ( outValueLength == NULL ) )
@@ -1718,9 +2024,13 @@ JSONStatus_t JSON_SearchConst( const char * buf,
     }
     else
     {
-        ret = multiSearch( buf, max, query, queryLength, &value, outValueLength );
+        statsQuery_( max );
+        ret = multiSearch( buf, max, query, queryLength, &value, &length );
     }
 
+    /* The search stopped at the end of the value found, or where it gave up. */
+    traceProbe4_( search__return, max, queryLength, ret, value + length );
+
     if( ret == JSONSuccess )
     {
         JSONTypes_t t = getType( buf[ value ] );
@@ -1729,10 +2039,11 @@ JSONStatus_t JSON_SearchConst( const char * buf,
         {
             /* strip the surrounding quotes */
             value++;
-            *outValueLength -= 2U;
+            length -= 2U;
         }
 
         *outValue = &buf[ value ];
+        *outValueLength = length;
 
         if( outType != NULL )
         {
@@ -1844,6 +2155,8 @@ JSONStatus_t JSON_Iterate( const char * buf,
     JSONStatus_t ret;
     size_t key = 0U, keyLength = 0U, value = 0U, valueLength = 0U;
 
+    traceProbe2_( iterate__entry, buf, max );
+
     if( ( buf == NULL ) || ( start == NULL ) || ( next == NULL ) ||
         ( outPair == NULL ) )
     {
@@ -1885,5 +2198,3486 @@ JSONStatus_t JSON_Iterate( const char * buf,
         outPair->jsonType = t;
     }
 
+    traceProbe3_( iterate__return, max, ret, ( next != NULL ) ? *next : 0U );
+
     return ret;
 }
+
+/** @cond DO_NOT_DOCUMENT */
+
+/**
+ * @brief State of a buffer being written.
+ *
+ * Writes beyond the capacity are dropped, but still counted in length,
+ * so that the size required may be reported to the caller.
+ */
+typedef struct
+{
+    char * buf;
+    size_t max;
+    size_t length;
+} writer_t;
+
+/**
+ * @brief State of one object being merged by JSON_MergePatch().
+ *
+ * The keys of the patch object are first written to a table in the
+ * scratch slots.  The members of the target object are then visited,
+ * and afterwards those of the patch object, to append the members
+ * that were not merged into a target member.
+ */
+typedef struct
+{
+    size_t targetNext; /**< Index of the next target member, or 0 if there is none. */
+    size_t patchNext;  /**< Index of the next patch member, or 0 if there is none. */
+    size_t table;      /**< Index of the first scratch slot of the patch key table. */
+    bool hasMembers;   /**< True once a member has been written. */
+} mergeFrame_t;
+
+/**
+ * @brief State of JSON_MergePatch().
+ *
+ * The key table of the innermost object ends at scratchUsed.
+ */
+typedef struct
+{
+    const char * target;
+    size_t targetLength;
+    const char * patch;
+    size_t patchLength;
+    JSONKeySlot_t * scratch;
+    size_t scratchCapacity;
+    size_t scratchUsed;
+    writer_t out;
+    mergeFrame_t * stack;
+    size_t depth;
+} mergeContext_t;
+
+/**
+ * @brief Append bytes to an output buffer.
+ *
+ * @param[in,out] w  The output buffer.
+ * @param[in] src  The bytes to append.
+ * @param[in] length  The number of bytes to append.
+ */
+static void writeBytes( writer_t * w,
+                        const char * src,
+                        size_t length )
+{
+    size_t i = 0U;
+
+    coreJSON_ASSERT( ( w != NULL ) && ( src != NULL ) );
+
+    for( i = 0U; i < length; i++ )
+    {
+        if( w->length < w->max )
+        {
+            w->buf[ w->length ] = src[ i ];
+        }
+
+        if( w->length < SIZE_MAX )
+        {
+            w->length++;
+        }
+    }
+}
+
+/**
+ * @brief Hash a key with 32-bit FNV-1a.
+ *
+ * @param[in] key  The key to hash.
+ * @param[in] keyLength  Length of the key.
+ *
+ * @return the hash.
+ */
+#define FNV_OFFSET_BASIS    ( 2166136261U )
+#define FNV_PRIME           ( 16777619U )
+static uint32_t hashKey( const char * key,
+                         size_t keyLength )
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    size_t i = 0U;
+
+    coreJSON_ASSERT( key != NULL );
+
+    for( i = 0U; i < keyLength; i++ )
+    {
+        hash ^= ( uint32_t ) ( uint8_t ) key[ i ];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Probe a key table for a key.
+ *
+ * @param[in] buf  The buffer the table was written for.
+ * @param[in] max  The size of the buffer.
+ * @param[in] table  The slots.
+ * @param[in] capacity  The number of slots.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ * @param[out] outSlot  A pointer to receive the slot holding the key, else
+ * the empty slot that ended the probe, else @p capacity if the table is full.
+ *
+ * @return true if the key is found;
+ * false otherwise.
+ */
+static bool findKeySlot( const char * buf,
+                         size_t max,
+                         const JSONKeySlot_t * table,
+                         size_t capacity,
+                         const char * key,
+                         size_t keyLength,
+                         size_t * outSlot )
+{
+    bool ret = false;
+    size_t n = 0U, probes = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( table != NULL ) && ( capacity > 0U ) );
+    coreJSON_ASSERT( ( key != NULL ) && ( outSlot != NULL ) );
+
+    n = ( size_t ) hashKey( key, keyLength ) % capacity;
+    *outSlot = capacity;
+
+    for( probes = 0U; probes < capacity; probes++ )
+    {
+        const JSONKeySlot_t * slot = &table[ n ];
+
+        if( slot->key == 0U )
+        {
+            *outSlot = n;
+            break;
+        }
+
+        /* Trust a slot only as far as it lies within the buffer. */
+        if( ( slot->keyLength == keyLength ) && ( slot->key < max ) &&
+            ( keyLength <= ( max - slot->key ) ) && ( slot->value < max ) &&
+            ( strnEq( &buf[ slot->key ], key, keyLength ) == true ) )
+        {
+            *outSlot = n;
+            ret = true;
+            break;
+        }
+
+        n = ( n == ( capacity - 1U ) ) ? 0U : ( n + 1U );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Output indexes for the next member of an object being merged.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in] max  The size of the buffer.
+ * @param[in,out] next  The index of the next member; receives the index
+ * of the member after it, or 0 if there is none.
+ * @param[out] key  A pointer to receive the index of the key.
+ * @param[out] keyLength  A pointer to receive the length of the key.
+ * @param[out] value  A pointer to receive the index of the value.
+ * @param[out] valueLength  A pointer to receive the length of the value.
+ *
+ * @return true if a member was present;
+ * false otherwise.
+ */
+static bool mergeNextMember( const char * buf,
+                             size_t max,
+                             size_t * next,
+                             size_t * key,
+                             size_t * keyLength,
+                             size_t * value,
+                             size_t * valueLength )
+{
+    bool ret = false;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( max > 0U ) && ( next != NULL ) );
+
+    if( *next > 0U )
+    {
+        ret = nextKeyValuePair( buf, next, max, key, keyLength, value, valueLength );
+    }
+
+    if( ( ret == false ) || ( skipSpaceAndComma( buf, next, max ) == false ) )
+    {
+        *next = 0U;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find a key in the patch key table of the innermost object.
+ *
+ * @param[in] ctx  The merge state.
+ * @param[in] frame  The innermost object.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ *
+ * @return the slot holding the key, or NULL if it is not found.
+ */
+static JSONKeySlot_t * mergeFindKey( const mergeContext_t * ctx,
+                                     const mergeFrame_t * frame,
+                                     const char * key,
+                                     size_t keyLength )
+{
+    JSONKeySlot_t * ret = NULL;
+    size_t capacity = 0U, n = 0U;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( frame != NULL ) && ( key != NULL ) );
+    coreJSON_ASSERT( frame->table <= ctx->scratchUsed );
+
+    capacity = ctx->scratchUsed - frame->table;
+
+    if( ( capacity > 0U ) &&
+        ( findKeySlot( ctx->patch, ctx->patchLength, &ctx->scratch[ frame->table ],
+                       capacity, key, keyLength, &n ) == true ) )
+    {
+        ret = &ctx->scratch[ frame->table + n ];
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Count the members of a patch object.
+ *
+ * @param[in] ctx  The merge state.
+ * @param[in] patch  The index of the patch object.
+ * @param[out] outCount  A pointer to receive the number of members.
+ *
+ * @return true if the object ends within the patch;
+ * false otherwise.
+ */
+static bool mergeCountMembers( const mergeContext_t * ctx,
+                               size_t patch,
+                               size_t * outCount )
+{
+    bool ret = false;
+    size_t i = patch + 1U, count = 0U;
+    size_t key = 0U, keyLength = 0U, value = 0U, valueLength = 0U;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( patch < ctx->patchLength ) && ( outCount != NULL ) );
+
+    skipSpace( ctx->patch, &i, ctx->patchLength );
+
+    while( nextKeyValuePair( ctx->patch, &i, ctx->patchLength,
+                             &key, &keyLength, &value, &valueLength ) == true )
+    {
+        count++;
+
+        if( skipSpaceAndComma( ctx->patch, &i, ctx->patchLength ) == false )
+        {
+            break;
+        }
+    }
+
+    if( ( i < ctx->patchLength ) && isCurlyClose_( ctx->patch[ i ] ) )
+    {
+        ret = true;
+        *outCount = count;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Write the keys of a patch object to a table in the scratch slots.
+ *
+ * The table has twice as many slots as the object has members.  Where a
+ * key is repeated, the value of the last is kept, as RFC 7396 applies the
+ * members of a patch in turn.
+ *
+ * @param[in,out] ctx  The merge state.
+ * @param[in] patch  The index of the patch object.
+ *
+ * @return #JSONSuccess if the table was written;
+ * #JSONIllegalDocument if the object does not end within the patch;
+ * #JSONInsufficientMemory if there are too few scratch slots.
+ */
+static JSONStatus_t mergeWriteTable( mergeContext_t * ctx,
+                                     size_t patch )
+{
+    JSONStatus_t ret = JSONSuccess;
+    JSONKeySlot_t * table = NULL;
+    size_t i = 0U, count = 0U, capacity = 0U, n = 0U;
+    size_t key = 0U, keyLength = 0U, value = 0U, valueLength = 0U;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( patch < ctx->patchLength ) );
+    coreJSON_ASSERT( isCurlyOpen_( ctx->patch[ patch ] ) );
+
+    if( mergeCountMembers( ctx, patch, &count ) == false )
+    {
+        ret = JSONIllegalDocument;
+    }
+    else if( count > ( ( ctx->scratchCapacity - ctx->scratchUsed ) / 2U ) )
+    {
+        ret = JSONInsufficientMemory;
+    }
+    else if( count > 0U )
+    {
+        table = &ctx->scratch[ ctx->scratchUsed ];
+        capacity = count * 2U;
+        ctx->scratchUsed += capacity;
+
+        for( n = 0U; n < capacity; n++ )
+        {
+            table[ n ].key = 0U;
+        }
+
+        i = patch + 1U;
+        skipSpace( ctx->patch, &i, ctx->patchLength );
+
+        /* The same count members are read, so an empty slot always remains. */
+        while( mergeNextMember( ctx->patch, ctx->patchLength, &i,
+                                &key, &keyLength, &value, &valueLength ) == true )
+        {
+            if( findKeySlot( ctx->patch, ctx->patchLength, table, capacity,
+                             &ctx->patch[ key ], keyLength, &n ) == false )
+            {
+                table[ n ].key = key;
+                table[ n ].keyLength = keyLength;
+            }
+
+            table[ n ].value = value;
+        }
+    }
+    else
+    {
+        /* An empty object needs no table. */
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Begin merging an object into the output.
+ *
+ * @param[in,out] ctx  The merge state.
+ * @param[in] hasTarget  True if there is a target object to merge into.
+ * @param[in] target  The index of the target object.
+ * @param[in] patch  The index of the patch object.
+ *
+ * @return #JSONSuccess if the object was begun;
+ * #JSONMaxDepthExceeded if the nesting is too deep;
+ * otherwise the error met writing the patch key table.
+ */
+static JSONStatus_t mergePush( mergeContext_t * ctx,
+                               bool hasTarget,
+                               size_t target,
+                               size_t patch )
+{
+    JSONStatus_t ret = JSONMaxDepthExceeded;
+    mergeFrame_t * frame = NULL;
+    size_t table = 0U;
+
+    coreJSON_ASSERT( ctx != NULL );
+
+    if( ctx->depth < ( size_t ) JSON_MAX_DEPTH )
+    {
+        table = ctx->scratchUsed;
+        ret = mergeWriteTable( ctx, patch );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        frame = &ctx->stack[ ctx->depth ];
+        ctx->depth++;
+
+        frame->targetNext = 0U;
+        frame->patchNext = patch + 1U;
+        frame->table = table;
+        frame->hasMembers = false;
+
+        if( hasTarget == true )
+        {
+            frame->targetNext = target + 1U;
+            skipSpace( ctx->target, &frame->targetNext, ctx->targetLength );
+        }
+
+        skipSpace( ctx->patch, &frame->patchNext, ctx->patchLength );
+        writeBytes( &ctx->out, "{", 1U );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Write a key of the object being merged.
+ *
+ * @param[in,out] ctx  The merge state.
+ * @param[in,out] frame  The object being merged.
+ * @param[in] buf  The buffer containing the key.
+ * @param[in] key  The index of the key.
+ * @param[in] keyLength  The length of the key.
+ */
+static void mergeWriteKey( mergeContext_t * ctx,
+                           mergeFrame_t * frame,
+                           const char * buf,
+                           size_t key,
+                           size_t keyLength )
+{
+    coreJSON_ASSERT( ( ctx != NULL ) && ( frame != NULL ) && ( buf != NULL ) );
+    coreJSON_ASSERT( key > 0U );
+
+    if( frame->hasMembers == true )
+    {
+        writeBytes( &ctx->out, ",", 1U );
+    }
+
+    /* include the surrounding quotes */
+    writeBytes( &ctx->out, &buf[ key - 1U ], keyLength + 2U );
+    writeBytes( &ctx->out, ":", 1U );
+    frame->hasMembers = true;
+}
+
+/**
+ * @brief Merge a patch value into the object being merged.
+ *
+ * @param[in,out] ctx  The merge state.
+ * @param[in,out] frame  The object being merged.
+ * @param[in] buf  The buffer containing the key.
+ * @param[in] key  The index of the key.
+ * @param[in] keyLength  The length of the key.
+ * @param[in] target  The index of the target value, or 0 if there is none.
+ * @param[in] patch  The index of the patch value.
+ * @param[in] patchLength  The length of the patch value.
+ *
+ * @return #JSONSuccess if the value was merged;
+ * otherwise the error met beginning a nested object.
+ */
+static JSONStatus_t mergeValue( mergeContext_t * ctx,
+                                mergeFrame_t * frame,
+                                const char * buf,
+                                size_t key,
+                                size_t keyLength,
+                                size_t target,
+                                size_t patch,
+                                size_t patchLength )
+{
+    JSONStatus_t ret = JSONSuccess;
+    JSONTypes_t t;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( frame != NULL ) );
+
+    t = getType( ctx->patch[ patch ] );
+
+    if( t == JSONObject )
+    {
+        bool hasTarget = ( ( target > 0U ) && isCurlyOpen_( ctx->target[ target ] ) ) ? true : false;
+
+        mergeWriteKey( ctx, frame, buf, key, keyLength );
+        ret = mergePush( ctx, hasTarget, target, patch );
+    }
+    else if( t != JSONNull )
+    {
+        mergeWriteKey( ctx, frame, buf, key, keyLength );
+        writeBytes( &ctx->out, &ctx->patch[ patch ], patchLength );
+    }
+    else
+    {
+        /* A null value removes the key. */
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Merge the next member of the target object.
+ *
+ * The value is copied unless the patch has the same key.  The patch
+ * member is then merged and marked as used, by zeroing the value of its
+ * slot, so that a repeated target key is not merged twice.
+ *
+ * @param[in,out] ctx  The merge state.
+ * @param[in,out] frame  The object being merged.
+ *
+ * @return #JSONSuccess if the member was merged;
+ * #JSONNotFound if there are no further members;
+ * otherwise the error met beginning a nested object.
+ */
+static JSONStatus_t mergeTargetMember( mergeContext_t * ctx,
+                                       mergeFrame_t * frame )
+{
+    JSONStatus_t ret = JSONNotFound;
+    JSONKeySlot_t * slot = NULL;
+    size_t key = 0U, keyLength = 0U, value = 0U, valueLength = 0U;
+    size_t i = 0U, patch = 0U, patchLength = 0U;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( frame != NULL ) );
+
+    if( mergeNextMember( ctx->target, ctx->targetLength, &frame->targetNext,
+                         &key, &keyLength, &value, &valueLength ) == true )
+    {
+        ret = JSONSuccess;
+        slot = mergeFindKey( ctx, frame, &ctx->target[ key ], keyLength );
+
+        if( slot == NULL )
+        {
+            mergeWriteKey( ctx, frame, ctx->target, key, keyLength );
+            writeBytes( &ctx->out, &ctx->target[ value ], valueLength );
+        }
+        else if( slot->value > 0U )
+        {
+            i = slot->value;
+            patch = i;
+            slot->value = 0U;
+
+            /* The value was read once already, when the table was written. */
+            ( void ) nextValue( ctx->patch, &i, ctx->patchLength, &patch, &patchLength );
+            ret = mergeValue( ctx, frame, ctx->target, key, keyLength, value, patch, patchLength );
+        }
+        else
+        {
+            /* The patch member was merged with an earlier target member. */
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Merge the next member of the patch object.
+ *
+ * The value is added if the slot of its key holds this member, i.e. if
+ * it is the last member with the key and it was not merged into a target
+ * member by mergeTargetMember().
+ *
+ * @param[in,out] ctx  The merge state.
+ * @param[in,out] frame  The object being merged.
+ *
+ * @return #JSONSuccess if the member was merged;
+ * #JSONNotFound if there are no further members;
+ * otherwise the error met beginning a nested object.
+ */
+static JSONStatus_t mergePatchMember( mergeContext_t * ctx,
+                                      mergeFrame_t * frame )
+{
+    JSONStatus_t ret = JSONNotFound;
+    JSONKeySlot_t * slot = NULL;
+    size_t key = 0U, keyLength = 0U, value = 0U, valueLength = 0U;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( frame != NULL ) );
+
+    if( mergeNextMember( ctx->patch, ctx->patchLength, &frame->patchNext,
+                         &key, &keyLength, &value, &valueLength ) == true )
+    {
+        ret = JSONSuccess;
+        slot = mergeFindKey( ctx, frame, &ctx->patch[ key ], keyLength );
+
+        if( ( slot != NULL ) && ( slot->value == value ) )
+        {
+            slot->value = 0U;
+            ret = mergeValue( ctx, frame, ctx->patch, key, keyLength, 0U, value, valueLength );
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance the merge by one member, or finish the innermost object.
+ *
+ * @param[in,out] ctx  The merge state.
+ *
+ * @return #JSONSuccess if the merge may continue;
+ * otherwise the error met beginning a nested object.
+ */
+static JSONStatus_t mergeStep( mergeContext_t * ctx )
+{
+    JSONStatus_t ret = JSONNotFound;
+    mergeFrame_t * frame = NULL;
+
+    coreJSON_ASSERT( ( ctx != NULL ) && ( ctx->depth > 0U ) );
+
+    frame = &ctx->stack[ ctx->depth - 1U ];
+
+    if( frame->targetNext > 0U )
+    {
+        ret = mergeTargetMember( ctx, frame );
+
+        if( ret == JSONNotFound )
+        {
+            ret = JSONSuccess;
+        }
+    }
+    else
+    {
+        ret = mergePatchMember( ctx, frame );
+
+        if( ret == JSONNotFound )
+        {
+            writeBytes( &ctx->out, "}", 1U );
+            ctx->scratchUsed = frame->table;
+            ctx->depth--;
+            ret = JSONSuccess;
+        }
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_MergePatch( const char * target,
+                              size_t targetLength,
+                              const char * patch,
+                              size_t patchLength,
+                              JSONKeySlot_t * scratch,
+                              size_t scratchCapacity,
+                              char * out,
+                              size_t outCapacity,
+                              size_t * outLength )
+{
+    JSONStatus_t ret = JSONSuccess;
+    mergeContext_t ctx;
+    mergeFrame_t stack[ JSON_MAX_DEPTH ];
+    size_t t = 0U, p = 0U, value = 0U, valueLength = 0U;
+
+    if( ( target == NULL ) || ( patch == NULL ) ||
+        ( out == NULL ) || ( outLength == NULL ) ||
+        ( ( scratch == NULL ) && ( scratchCapacity > 0U ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( targetLength == 0U ) || ( patchLength == 0U ) || ( outCapacity == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        ctx.target = target;
+        ctx.targetLength = targetLength;
+        ctx.patch = patch;
+        ctx.patchLength = patchLength;
+        ctx.scratch = scratch;
+        ctx.scratchCapacity = scratchCapacity;
+        ctx.scratchUsed = 0U;
+        ctx.out.buf = out;
+        ctx.out.max = outCapacity;
+        ctx.out.length = 0U;
+        ctx.stack = stack;
+        ctx.depth = 0U;
+
+        skipSpace( target, &t, targetLength );
+        skipSpace( patch, &p, patchLength );
+
+        if( ( p < patchLength ) && isCurlyOpen_( patch[ p ] ) )
+        {
+            bool hasTarget = ( ( t < targetLength ) && isCurlyOpen_( target[ t ] ) ) ? true : false;
+
+            ret = mergePush( &ctx, hasTarget, t, p );
+
+            while( ( ret == JSONSuccess ) && ( ctx.depth > 0U ) )
+            {
+                ret = mergeStep( &ctx );
+            }
+        }
+        else if( nextValue( patch, &p, patchLength, &value, &valueLength ) == true )
+        {
+            /* A patch that is not an object replaces the target. */
+            writeBytes( &ctx.out, &patch[ value ], valueLength );
+        }
+        else
+        {
+            ret = JSONIllegalDocument;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        if( ctx.out.length > outCapacity )
+        {
+            ret = JSONInsufficientMemory;
+        }
+
+        *outLength = ctx.out.length;
+    }
+    else if( ret == JSONInsufficientMemory )
+    {
+        /* The scratch slots ran out before the size required was known. */
+        *outLength = 0U;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    return ret;
+}
+
+/** @cond DO_NOT_DOCUMENT */
+
+/**
+ * @brief Is a character other than whitespace part of a literal or number?
+ */
+#define isScalarChar_( x )                                           \
+    ( !isOpenBracket_( x ) && !isCloseBracket_( x ) &&               \
+      ( ( x ) != ',' ) && ( ( x ) != ':' ) && ( ( x ) != '"' ) )
+
+/**
+ * @brief Move the next token of a document being minified.
+ *
+ * A run of whitespace is dropped, a string is moved as a whole, and any
+ * other character is moved by itself.  A run of whitespace between two
+ * scalar characters is kept as one space, so that "[1 2]" does not
+ * become the valid "[12]".
+ *
+ * @param[in,out] buf  The buffer to minify.
+ * @param[in,out] start  The index at which to read the next token.
+ * @param[in] max  The size of the buffer.
+ * @param[in,out] end  The index at which to write the next token.
+ *
+ * @return true if the token was moved;
+ * false if a string is malformed.
+ */
+static bool minifyToken( char * buf,
+                         size_t * start,
+                         size_t max,
+                         size_t * end )
+{
+    bool ret = true;
+    size_t i = 0U, j = 0U, tokenEnd = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( end != NULL ) );
+    coreJSON_ASSERT( ( *end <= *start ) && ( *start < max ) );
+
+    i = *start;
+    j = *end;
+    tokenEnd = i + 1U;
+
+    if( isspace_( buf[ i ] ) )
+    {
+        skipSpace( buf, &i, max );
+        tokenEnd = i;
+
+        if( ( j > 0U ) && ( i < max ) &&
+            isScalarChar_( buf[ j - 1U ] ) && isScalarChar_( buf[ i ] ) )
+        {
+            buf[ j ] = ' ';
+            j++;
+        }
+    }
+    else if( buf[ i ] == '"' )
+    {
+        tokenEnd = i;
+        ret = skipString( buf, &tokenEnd, max );
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == true )
+    {
+        while( i < tokenEnd )
+        {
+            buf[ j ] = buf[ i ];
+            i++;
+            j++;
+        }
+
+        *start = i;
+        *end = j;
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_Minify( char * buf,
+                          size_t max,
+                          size_t * outLength )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U, j = 0U;
+
+    if( ( buf == NULL ) || ( outLength == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        while( i < max )
+        {
+            if( minifyToken( buf, &i, max, &j ) != true )
+            {
+                ret = JSONIllegalDocument;
+                break;
+            }
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *outLength = j;
+    }
+
+    return ret;
+}
+
+/** @cond DO_NOT_DOCUMENT */
+
+/**
+ * @brief Find the end of the line beginning at an index.
+ *
+ * @param[in] buf  The buffer to scan.
+ * @param[in] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ *
+ * @return the index of the next '\n', or max if there is none.
+ */
+static size_t findNewline( const char * buf,
+                           size_t start,
+                           size_t max )
+{
+    size_t i = 0U;
+
+    coreJSON_ASSERT( buf != NULL );
+
+    for( i = start; i < max; i++ )
+    {
+        if( buf[ i ] == '\n' )
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/**
+ * @brief Validate one record of a newline-delimited stream.
+ *
+ * @param[in] buf  The buffer holding the stream.
+ * @param[in] start  The index of the first non-whitespace byte of the record.
+ * @param[in] end  The index of the '\n' ending the record, or max.
+ * @param[in] max  The size of the buffer.
+ *
+ * @return the result of JSON_Validate(), except that #JSONPartial is
+ * reported as #JSONIllegalDocument for a record ended by a '\n'.
+ */
+static JSONStatus_t validateRecord( const char * buf,
+                                    size_t start,
+                                    size_t end,
+                                    size_t max )
+{
+    JSONStatus_t ret;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start < end ) && ( end <= max ) );
+
+    ret = JSON_Validate( &buf[ start ], end - start );
+
+    if( ( ret == JSONPartial ) && ( end < max ) )
+    {
+        ret = JSONIllegalDocument;
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_NextRecord( const char * buf,
+                              size_t max,
+                              size_t * offset,
+                              size_t * outRecordStart,
+                              size_t * outRecordLength,
+                              JSONStatus_t * outRecordStatus )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, start = 0U, end = 0U;
+
+    if( ( buf == NULL ) || ( offset == NULL ) || ( outRecordStart == NULL ) ||
+        ( outRecordLength == NULL ) || ( outRecordStatus == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( *offset > max )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        ret = JSONNotFound;
+        i = *offset;
+
+        while( ( ret == JSONNotFound ) && ( i < max ) )
+        {
+            start = i;
+            end = findNewline( buf, i, max );
+            i = ( end < max ) ? ( end + 1U ) : max;
+
+            /* A line may be empty, even at the start of the buffer. */
+            if( start < end )
+            {
+                skipSpace( buf, &start, end );
+            }
+
+            if( start < end )
+            {
+                ret = JSONSuccess;
+            }
+        }
+
+        *offset = i;
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *outRecordStart = start;
+        *outRecordLength = end - start;
+        *outRecordStatus = validateRecord( buf, start, end, max );
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_ValidatePrefix( const char * buf,
+                                  size_t max,
+                                  size_t * outConsumed )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    if( ( buf == NULL ) || ( outConsumed == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        ret = skipValue( buf, &i, max );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *outConsumed = i;
+    }
+
+    return ret;
+}
+
+/** @cond DO_NOT_DOCUMENT */
+
+/**
+ * @brief Advance buffer index to the first member of a collection.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the opening bracket.
+ * @param[in] max  The size of the buffer.
+ * @param[in] open  The opening bracket expected.
+ * @param[in] close  The matching closing bracket.
+ *
+ * @return #JSONSuccess if a member follows;
+ * #JSONNotFound if the collection is empty;
+ * #JSONPartial if the buffer ends first;
+ * #JSONIllegalDocument if the collection does not begin with @p open.
+ */
+static JSONStatus_t cursorOpen( const char * buf,
+                                size_t * start,
+                                size_t max,
+                                char open,
+                                char close )
+{
+    JSONStatus_t ret = JSONIllegalDocument;
+    size_t i = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+
+    if( buf[ i ] == open )
+    {
+        i++;
+        skipSpace( buf, &i, max );
+
+        if( i == max )
+        {
+            ret = JSONPartial;
+        }
+        else if( buf[ i ] == close )
+        {
+            ret = JSONNotFound;
+        }
+        else
+        {
+            ret = JSONSuccess;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance buffer index beyond the separator that follows a member
+ * of a collection.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index just past the member.
+ * @param[in] max  The size of the buffer.
+ * @param[in] close  The closing bracket of the collection.
+ *
+ * @return #JSONSuccess if another member follows;
+ * #JSONNotFound if the collection ends;
+ * #JSONPartial if the buffer ends first;
+ * #JSONIllegalDocument otherwise.
+ */
+static JSONStatus_t cursorSeparator( const char * buf,
+                                     size_t * start,
+                                     size_t max,
+                                     char close )
+{
+    JSONStatus_t ret = JSONIllegalDocument;
+    size_t i = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+
+    i = *start;
+    skipSpace( buf, &i, max );
+
+    if( i == max )
+    {
+        ret = JSONPartial;
+    }
+    else if( buf[ i ] == close )
+    {
+        ret = JSONNotFound;
+    }
+    else if( buf[ i ] == ',' )
+    {
+        i++;
+        skipSpace( buf, &i, max );
+
+        /* JSON does not permit a trailing comma. */
+        if( i == max )
+        {
+            ret = JSONPartial;
+        }
+        else if( !isCloseBracket_( buf[ i ] ) )
+        {
+            ret = JSONSuccess;
+        }
+        else
+        {
+            /* MISRA 15.7 */
+        }
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance buffer index beyond a key and its colon.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which the key begins.
+ * @param[in] max  The size of the buffer.
+ * @param[out] outKey  A pointer to receive the index of the key, after its quote.
+ * @param[out] outKeyLength  A pointer to receive the length of the key.
+ *
+ * @return #JSONSuccess if a key, colon and the start of a value were present;
+ * #JSONPartial if the buffer ends first;
+ * #JSONIllegalDocument otherwise.
+ */
+static JSONStatus_t cursorKey( const char * buf,
+                               size_t * start,
+                               size_t max,
+                               size_t * outKey,
+                               size_t * outKeyLength )
+{
+    JSONStatus_t ret = JSONIllegalDocument;
+    size_t i = 0U, keyStart = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+    coreJSON_ASSERT( ( outKey != NULL ) && ( outKeyLength != NULL ) );
+
+    i = *start;
+    keyStart = i;
+
+    if( skipString( buf, &i, max ) == true )
+    {
+        statsScanned_( i - keyStart );
+        *outKey = keyStart + 1U;
+        *outKeyLength = i - keyStart - 2U;
+        skipSpace( buf, &i, max );
+
+        if( ( i < max ) && ( buf[ i ] == ':' ) )
+        {
+            i++;
+            skipSpace( buf, &i, max );
+            ret = ( i < max ) ? JSONSuccess : JSONPartial;
+        }
+        else if( i == max )
+        {
+            ret = JSONPartial;
+        }
+        else
+        {
+            /* MISRA 15.7 */
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Words of eight bytes, for testing the bytes of a buffer eight
+ * at a time.
+ */
+#define WORD_BYTES    ( 8U )
+#define WORD_ONES     ( ( ( ( uint64_t ) 0x01010101U ) << 32 ) | 0x01010101U )
+#define WORD_LOW7     ( ( ( ( uint64_t ) 0x7F7F7F7FU ) << 32 ) | 0x7F7F7F7FU )
+#define WORD_HIGH     ( 0x80U )
+
+/* Read eight bytes of a buffer as a word, the first in the lowest byte. */
+#define byteAt_( p, n )    ( ( uint64_t ) ( uint8_t ) ( p )[ n ] )
+#define loadWord_( p )                                                   \
+    ( byteAt_( p, 0 ) | ( byteAt_( p, 1 ) << 8 ) |                       \
+      ( byteAt_( p, 2 ) << 16 ) | ( byteAt_( p, 3 ) << 24 ) |            \
+      ( byteAt_( p, 4 ) << 32 ) | ( byteAt_( p, 5 ) << 40 ) |            \
+      ( byteAt_( p, 6 ) << 48 ) | ( byteAt_( p, 7 ) << 56 ) )
+
+/**
+ * @brief Mark the bytes of a word that are equal to a given byte.
+ *
+ * @param[in] word  The word to test.
+ * @param[in] c  The byte to look for.
+ *
+ * @return a word with the high bit set in each byte equal to @p c, and
+ * no other bit set.
+ */
+static uint64_t markBytes( uint64_t word,
+                           char c )
+{
+    uint64_t x = word ^ ( WORD_ONES * ( uint8_t ) c );
+
+    /* Adding 0x7F to the low seven bits of a byte sets its high bit
+     * unless they are zero; a byte of x is zero if neither that bit
+     * nor its own high bit is set. */
+    return ~( ( ( x & WORD_LOW7 ) + WORD_LOW7 ) | x | WORD_LOW7 );
+}
+
+/**
+ * @brief Find the first marked byte of a word.
+ *
+ * @param[in] marks  A word returned by markBytes().
+ *
+ * @return the position of the first marked byte; WORD_BYTES if none is marked.
+ */
+static size_t firstMarked( uint64_t marks )
+{
+    size_t ret = WORD_BYTES;
+    uint64_t m = marks;
+
+    if( m != 0U )
+    {
+        /* Halve the bytes in which to look, three times. */
+        ret = 0U;
+
+        if( ( m & 0xFFFFFFFFU ) == 0U )
+        {
+            m >>= 32;
+            ret += 4U;
+        }
+
+        if( ( m & 0xFFFFU ) == 0U )
+        {
+            m >>= 16;
+            ret += 2U;
+        }
+
+        if( ( m & 0xFFU ) == 0U )
+        {
+            ret += 1U;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance buffer index to the closing quote of a string, without
+ * validating the string.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the opening quote; receives the index
+ * of the closing quote, or max if there is none.
+ * @param[in] max  The size of the buffer.
+ */
+static void skipQuoted( const char * buf,
+                        size_t * start,
+                        size_t max )
+{
+    size_t i = 0U;
+    uint64_t word = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start + 1U;
+
+    /* Only a backslash can keep a quote from ending the string. */
+    while( ( i < max ) && ( buf[ i ] != '"' ) )
+    {
+        if( buf[ i ] == '\\' )
+        {
+            i += 2U;
+        }
+        else if( ( max - i ) >= WORD_BYTES )
+        {
+            /* buf[ i ] is neither, so this advances at least one byte. */
+            word = loadWord_( &buf[ i ] );
+            i += firstMarked( markBytes( word, '"' ) | markBytes( word, '\\' ) );
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    *start = ( i < max ) ? i : max;
+}
+
+/**
+ * @brief Count the members of a collection without validating them.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the opening bracket; receives the index
+ * past the closing bracket.
+ * @param[in] max  The size of the buffer.
+ * @param[out] outCount  A pointer to receive the number of members.
+ *
+ * @return #JSONSuccess if the collection ends within the buffer;
+ * #JSONPartial otherwise.
+ */
+static JSONStatus_t countMembers( const char * buf,
+                                  size_t * start,
+                                  size_t max,
+                                  size_t * outCount )
+{
+    JSONStatus_t ret = JSONPartial;
+    size_t i = 0U, depth = 1U, count = 0U;
+    bool empty = true;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+    coreJSON_ASSERT( ( outCount != NULL ) && isOpenBracket_( buf[ *start ] ) );
+
+    for( i = *start + 1U; i < max; i++ )
+    {
+        char c = buf[ i ];
+
+        if( isCloseBracket_( c ) && ( depth == 1U ) )
+        {
+            ret = JSONSuccess;
+            break;
+        }
+
+        if( !isspace_( c ) )
+        {
+            empty = false;
+        }
+
+        if( c == '"' )
+        {
+            skipQuoted( buf, &i, max );
+        }
+        else if( isOpenBracket_( c ) )
+        {
+            depth++;
+        }
+        else if( isCloseBracket_( c ) )
+        {
+            depth--;
+        }
+        else if( ( c == ',' ) && ( depth == 1U ) )
+        {
+            count++;
+        }
+        else
+        {
+            /* MISRA 15.7 */
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        statsScanned_( i + 1U - *start );
+        *start = i + 1U;
+        *outCount = ( empty == true ) ? 0U : ( count + 1U );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Skip a value without validating it.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which the value begins.
+ * @param[in] max  The size of the buffer.
+ *
+ * @return true if the value ends within the buffer;
+ * false otherwise.
+ */
+static bool skipTrusted( const char * buf,
+                         size_t * start,
+                         size_t max )
+{
+    bool ret = false;
+    size_t i = 0U, n = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+
+    if( isOpenBracket_( buf[ i ] ) )
+    {
+        ret = ( countMembers( buf, &i, max, &n ) == JSONSuccess );
+    }
+    else
+    {
+        if( buf[ i ] == '"' )
+        {
+            skipQuoted( buf, &i, max );
+            ret = ( i < max );
+            i++;
+        }
+        else
+        {
+            while( ( i < max ) && !isspace_( buf[ i ] ) &&
+                   ( buf[ i ] != ',' ) && !isCloseBracket_( buf[ i ] ) )
+            {
+                i++;
+            }
+
+            ret = ( i > *start );
+        }
+
+        if( ret == true )
+        {
+            statsScanned_( i - *start );
+        }
+    }
+
+    if( ret == true )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief How the values passed over by a search are skipped.
+ */
+typedef struct
+{
+    const JSONIndexEntry_t * index; /* An index of the buffer, or NULL. */
+    size_t count;                   /* The number of entries in the index. */
+    bool trusted;                   /* Values are skipped without being validated. */
+} skipContext_t;
+
+/**
+ * @brief Find the index entry of a collection.
+ *
+ * @param[in] index  The entries, in order of their opening brackets.
+ * @param[in] count  The number of entries.
+ * @param[in] open  The index of the opening bracket.
+ *
+ * @return the position of the entry; count if there is none.
+ */
+static size_t findIndexEntry( const JSONIndexEntry_t * index,
+                              size_t count,
+                              size_t open )
+{
+    size_t low = 0U, high = count, mid = 0U, ret = count;
+
+    coreJSON_ASSERT( ( index != NULL ) || ( count == 0U ) );
+
+    while( low < high )
+    {
+        mid = low + ( ( high - low ) / 2U );
+
+        if( index[ mid ].open < open )
+        {
+            low = mid + 1U;
+        }
+        else if( index[ mid ].open > open )
+        {
+            high = mid;
+        }
+        else
+        {
+            ret = mid;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Skip a value passed over by a search.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which the value begins.
+ * @param[in] max  The size of the buffer.
+ * @param[in] ctx  How to skip the value, or NULL to scan it.
+ *
+ * @return #JSONNotFound if the value is trusted but does not end within
+ * the buffer; #JSONSuccess if a
+ * collection is in the index; otherwise the value is scanned, and the
+ * result is the same as skipValue().
+ */
+static JSONStatus_t skipMember( const char * buf,
+                                size_t * start,
+                                size_t max,
+                                const skipContext_t * ctx )
+{
+    JSONStatus_t ret = JSONNotFound;
+    size_t i = 0U, n = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+
+    if( ctx == NULL )
+    {
+        ret = skipValue( buf, start, max );
+    }
+    else if( ctx->trusted == true )
+    {
+        if( skipTrusted( buf, start, max ) == true )
+        {
+            ret = JSONSuccess;
+        }
+    }
+    else
+    {
+        if( isOpenBracket_( buf[ i ] ) )
+        {
+            n = findIndexEntry( ctx->index, ctx->count, i );
+
+            /* Trust an entry only as far as it is within the buffer
+             * and holds a matching bracket. */
+            if( ( n < ctx->count ) && ( ctx->index[ n ].close > i ) && ( ctx->index[ n ].close < max ) &&
+                isMatchingBracket_( buf[ i ], buf[ ctx->index[ n ].close ] ) )
+            {
+                ret = JSONSuccess;
+                *start = ctx->index[ n ].close + 1U;
+            }
+        }
+
+        if( ret != JSONSuccess )
+        {
+            ret = skipValue( buf, start, max );
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find the next place where a key appears in quotes.
+ *
+ * This is a byte search only; the place found may lie within a string or a
+ * nested collection.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ *
+ * @return the index of the opening quote; max if there is none.
+ */
+static size_t findQuotedKey( const char * buf,
+                             size_t start,
+                             size_t max,
+                             const char * key,
+                             size_t keyLength )
+{
+    size_t i = 0U, ret = max;
+    uint64_t word = 0U, next = 0U, marks = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start <= max ) );
+    coreJSON_ASSERT( ( key != NULL ) && ( keyLength > 0U ) );
+
+    i = start;
+
+    while( ( ret == max ) && ( ( max - i ) >= ( keyLength + 2U ) ) )
+    {
+        /* Mark the places, eight at a time, where both quotes and the first
+         * byte of the key match; near the end, test each place.  The bytes
+         * after each place are shifted in from the next word, as loads that
+         * overlap by a constant offset are not combined by compilers. */
+        marks = WORD_HIGH;
+
+        if( ( ( max - i ) > ( keyLength + 1U + WORD_BYTES ) ) &&
+            ( ( max - i ) >= ( 2U * WORD_BYTES ) ) )
+        {
+            word = loadWord_( &buf[ i ] );
+            next = ( word >> 8 ) | ( loadWord_( &buf[ i + WORD_BYTES ] ) << 56 );
+            marks = markBytes( word, '"' ) & markBytes( next, key[ 0 ] ) &
+                    markBytes( loadWord_( &buf[ i + keyLength + 1U ] ), '"' );
+        }
+
+        /* A marked place leaves room for the key, as a word is only tested
+         * with a word to spare. */
+        i += firstMarked( marks );
+
+        if( marks == 0U )
+        {
+            /* MISRA 15.7 */
+        }
+        else if( ( buf[ i ] == '"' ) && ( buf[ i + keyLength + 1U ] == '"' ) &&
+                 ( strnEq( &buf[ i + 1U ], key, keyLength ) == true ) )
+        {
+            ret = i;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Pass over eight bytes that hold no backslash or bracket.
+ *
+ * Each quote in such bytes begins or ends a string.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in] start  The index of the first byte.
+ * @param[in,out] inString  Whether start is within a string; updated to
+ * whether the byte after the eight is.
+ *
+ * @return true if the bytes were passed over;
+ * false if they hold a backslash or bracket.
+ */
+static bool skipQuotesOnly( const char * buf,
+                            size_t start,
+                            bool * inString )
+{
+    bool ret = false;
+    uint64_t word = 0U, folded = 0U, quotes = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( inString != NULL ) );
+
+    word = loadWord_( &buf[ start ] );
+
+    /* Setting bit 5 folds '[' and ']' into '{' and '}'. */
+    folded = word | ( WORD_ONES * 0x20U );
+
+    if( ( markBytes( word, '\\' ) | markBytes( folded, '{' ) | markBytes( folded, '}' ) ) == 0U )
+    {
+        /* Sum the marks into the top byte to count the quotes. */
+        quotes = ( ( markBytes( word, '"' ) >> 7 ) * WORD_ONES ) >> 56;
+
+        if( ( quotes & 1U ) == 1U )
+        {
+            *inString = !*inString;
+        }
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find a key of an object by searching for its bytes, without
+ * validating the object.
+ *
+ * Each place where the key appears in quotes is confirmed by tracking the
+ * strings and brackets before it: it must begin a string directly within
+ * the object, and be followed by a colon.  Nothing else is read, and the
+ * search ends at once if the key does not appear at all.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the object; receives the index of the value found.
+ * @param[in] max  The size of the buffer.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ *
+ * @return #JSONSuccess if the key is found;
+ * #JSONPartial if the buffer ends after the colon;
+ * #JSONNotFound if the object ends first, or the object is empty;
+ * otherwise the same as cursorOpen().
+ */
+static JSONStatus_t findKeyTrusted( const char * buf,
+                                    size_t * start,
+                                    size_t max,
+                                    const char * key,
+                                    size_t keyLength )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, scan = 0U, candidate = 0U, depth = 0U, end = 0U;
+    bool inString = false, match = false;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+    coreJSON_ASSERT( ( key != NULL ) && ( keyLength > 0U ) );
+
+    i = *start;
+    ret = cursorOpen( buf, &i, max, '{', '}' );
+    scan = i;
+    candidate = i;
+
+    while( ( ret == JSONSuccess ) && ( match == false ) )
+    {
+        candidate = findQuotedKey( buf, candidate, max, key, keyLength );
+
+        if( candidate >= max )
+        {
+            ret = JSONNotFound;
+        }
+
+        /* Track the strings and brackets up to the candidate. */
+        while( ( ret == JSONSuccess ) && ( scan < candidate ) )
+        {
+            if( ( ( candidate - scan ) >= WORD_BYTES ) &&
+                ( skipQuotesOnly( buf, scan, &inString ) == true ) )
+            {
+                scan += WORD_BYTES;
+            }
+            else if( inString == true )
+            {
+                if( buf[ scan ] == '\\' )
+                {
+                    scan++;
+                }
+                else if( buf[ scan ] == '"' )
+                {
+                    inString = false;
+                }
+                else
+                {
+                    /* MISRA 15.7 */
+                }
+
+                scan++;
+            }
+            else if( isCloseBracket_( buf[ scan ] ) && ( depth == 0U ) )
+            {
+                ret = JSONNotFound;
+            }
+            else
+            {
+                if( buf[ scan ] == '"' )
+                {
+                    inString = true;
+                }
+                else if( isOpenBracket_( buf[ scan ] ) )
+                {
+                    depth++;
+                }
+                else if( isCloseBracket_( buf[ scan ] ) )
+                {
+                    depth--;
+                }
+                else
+                {
+                    /* MISRA 15.7 */
+                }
+
+                scan++;
+            }
+        }
+
+        /* A string that begins directly within the object is a key if a
+         * colon follows. */
+        if( ( ret == JSONSuccess ) && ( scan == candidate ) &&
+            ( inString == false ) && ( depth == 0U ) )
+        {
+            end = candidate;
+            skipQuoted( buf, &end, max );
+
+            if( end == ( candidate + keyLength + 1U ) )
+            {
+                end++;
+                skipSpace( buf, &end, max );
+                match = ( end < max ) && ( buf[ end ] == ':' );
+            }
+        }
+
+        candidate++;
+    }
+
+    if( match == true )
+    {
+        statsScanned_( scan - *start );
+        end++;
+        skipSpace( buf, &end, max );
+
+        if( end < max )
+        {
+            *start = end;
+        }
+        else
+        {
+            ret = JSONPartial;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find a key of an object, skipping the values before it.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the object; receives the index of the value found.
+ * @param[in] max  The size of the buffer.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ * @param[in] ctx  How to skip the values passed over, or NULL to scan them.
+ *
+ * @return #JSONSuccess if the key is found;
+ * #JSONNotFound if the object ends first;
+ * otherwise the error met while reading the object.
+ *
+ * @note Trusted values are not skipped one by one; the key is searched for
+ * by findKeyTrusted().
+ */
+static JSONStatus_t cursorFind( const char * buf,
+                                size_t * start,
+                                size_t max,
+                                const char * key,
+                                size_t keyLength,
+                                const skipContext_t * ctx )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, found = 0U, foundLength = 0U;
+    bool match = false;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+
+    if( ( ctx != NULL ) && ( ctx->trusted == true ) )
+    {
+        ret = findKeyTrusted( buf, &i, max, key, keyLength );
+        match = ( ret == JSONSuccess );
+    }
+    else
+    {
+        ret = cursorOpen( buf, &i, max, '{', '}' );
+    }
+
+    while( ( ret == JSONSuccess ) && ( match == false ) )
+    {
+        ret = cursorKey( buf, &i, max, &found, &foundLength );
+        match = ( ret == JSONSuccess ) && ( foundLength == keyLength ) &&
+                ( strnEq( &buf[ found ], key, keyLength ) == true );
+
+        if( ( ret == JSONSuccess ) && ( match == false ) )
+        {
+            ret = skipMember( buf, &i, max, ctx );
+
+            if( ret == JSONSuccess )
+            {
+                statsAdd_( valuesScanned, 1U );
+                ret = cursorSeparator( buf, &i, max, '}' );
+            }
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find an element of an array, skipping the elements before it.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the array; receives the index of the element found.
+ * @param[in] max  The size of the buffer.
+ * @param[in] queryIndex  The position of the element.
+ * @param[in] ctx  How to skip the values passed over, or NULL to scan them.
+ *
+ * @return #JSONSuccess if the element is found;
+ * #JSONNotFound if the array ends first;
+ * otherwise the error met while reading the array.
+ */
+static JSONStatus_t cursorElement( const char * buf,
+                                   size_t * start,
+                                   size_t max,
+                                   uint32_t queryIndex,
+                                   const skipContext_t * ctx )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+    uint32_t n = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+    ret = cursorOpen( buf, &i, max, '[', ']' );
+
+    while( ( ret == JSONSuccess ) && ( n < queryIndex ) )
+    {
+        ret = skipMember( buf, &i, max, ctx );
+
+        if( ret == JSONSuccess )
+        {
+            statsAdd_( valuesScanned, 1U );
+            ret = cursorSeparator( buf, &i, max, ']' );
+        }
+
+        n++;
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance beyond the next part of a query.
+ *
+ * A part is either a key, or an index in square brackets.  A separator
+ * following the part is also skipped.
+ *
+ * @param[in] query  The query.
+ * @param[in,out] start  The index at which the part begins.
+ * @param[in] queryLength  Length of the query.
+ * @param[out] outKeyLength  A pointer to receive the length of a key.
+ * @param[out] outQueryIndex  A pointer to receive the index, or -1 for a key.
+ *
+ * @return #JSONSuccess if a part was present;
+ * #JSONBadParameter if the part is empty, or the index is too large
+ * to convert, or a key is followed by a trailing separator.
+ */
+static JSONStatus_t nextQueryPart( const char * query,
+                                   size_t * start,
+                                   size_t queryLength,
+                                   size_t * outKeyLength,
+                                   int32_t * outQueryIndex )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U;
+
+    coreJSON_ASSERT( ( query != NULL ) && ( start != NULL ) && ( *start < queryLength ) );
+    coreJSON_ASSERT( ( outKeyLength != NULL ) && ( outQueryIndex != NULL ) );
+
+    i = *start;
+    *outQueryIndex = -1;
+
+    if( isSquareOpen_( query[ i ] ) )
+    {
+        i++;
+        ( void ) skipDigits( query, &i, queryLength, outQueryIndex );
+
+        if( ( *outQueryIndex < 0 ) ||
+            ( i >= queryLength ) || !isSquareClose_( query[ i ] ) )
+        {
+            ret = JSONBadParameter;
+        }
+
+        i++;
+    }
+    else if( ( skipQueryPart( query, &i, queryLength, outKeyLength ) != true ) ||
+             /* catch an empty key part or a trailing separator */
+             ( i == ( queryLength - 1U ) ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        if( ( i < queryLength ) && isSeparator_( query[ i ] ) )
+        {
+            i++;
+        }
+
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Follow a query from a value, reading the document on demand.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in,out] start  The index of the value to search; receives the
+ * index of the value found.
+ * @param[in] max  size of the buffer.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the query.
+ * @param[in] ctx  How to skip the values passed over, or NULL to scan them.
+ *
+ * @return #JSONSuccess if the query is matched;
+ * #JSONBadParameter if the query is malformed;
+ * #JSONNotFound if a key or index is not present, or the value
+ * is not of the type the query expects;
+ * otherwise the error met while reading.
+ */
+static JSONStatus_t cursorSearch( const char * buf,
+                                  size_t * start,
+                                  size_t max,
+                                  const char * query,
+                                  size_t queryLength,
+                                  const skipContext_t * ctx )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U, q = 0U, key = 0U, keyLength = 0U;
+    int32_t queryIndex = -1;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+    coreJSON_ASSERT( ( query != NULL ) && ( queryLength > 0U ) );
+
+    i = *start;
+
+    while( ( ret == JSONSuccess ) && ( q < queryLength ) )
+    {
+        key = q;
+        ret = nextQueryPart( query, &q, queryLength, &keyLength, &queryIndex );
+
+        if( ret != JSONSuccess )
+        {
+            /* The query is malformed. */
+        }
+        else if( ( queryIndex < 0 ) && isCurlyOpen_( buf[ i ] ) )
+        {
+            ret = cursorFind( buf, &i, max, &query[ key ], keyLength, ctx );
+        }
+        else if( ( queryIndex >= 0 ) && isSquareOpen_( buf[ i ] ) )
+        {
+            ret = cursorElement( buf, &i, max, ( uint32_t ) queryIndex, ctx );
+        }
+        else
+        {
+            ret = JSONNotFound;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find a key in a JSON object, without reading its value.
+ *
+ * Same as objectSearch(), but stops at the first byte of the value found.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in,out] start  The index of the object; receives the index of the value found.
+ * @param[in] max  size of the buffer.
+ * @param[in] query  The key to search for.
+ * @param[in] queryLength  Length of the key.
+ *
+ * @return true if the key is matched and its value begins within the buffer;
+ * false otherwise.
+ */
+static bool objectSearchStart( const char * buf,
+                               size_t * start,
+                               size_t max,
+                               const char * query,
+                               size_t queryLength )
+{
+    bool ret = false;
+    size_t i = 0U, key = 0U, keyLength = 0U, value = 0U, valueLength = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+    coreJSON_ASSERT( query != NULL );
+
+    i = *start;
+
+    if( buf[ i ] == '{' )
+    {
+        i++;
+        skipSpace( buf, &i, max );
+
+        while( i < max )
+        {
+            if( nextKey( buf, &i, max, &key, &keyLength ) != true )
+            {
+                break;
+            }
+
+            if( ( queryLength == keyLength ) &&
+                ( strnEq( query, &buf[ key ], keyLength ) == true ) )
+            {
+                /* The value is not read, but must at least be present. */
+                ret = ( i < max ) && !isCloseBracket_( buf[ i ] ) && ( buf[ i ] != ',' );
+                break;
+            }
+
+            if( ( nextValue( buf, &i, max, &value, &valueLength ) != true ) ||
+                ( skipSpaceAndComma( buf, &i, max ) != true ) )
+            {
+                break;
+            }
+        }
+    }
+
+    if( ret == true )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find an index in a JSON array, without reading its value.
+ *
+ * Same as arraySearch(), but stops at the first byte of the value found.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in,out] start  The index of the array; receives the index of the value found.
+ * @param[in] max  size of the buffer.
+ * @param[in] queryIndex  The index to search for.
+ *
+ * @return true if the queryIndex is found and its value begins within the buffer;
+ * false otherwise.
+ */
+static bool arraySearchStart( const char * buf,
+                              size_t * start,
+                              size_t max,
+                              uint32_t queryIndex )
+{
+    bool ret = false;
+    size_t i = 0U, value = 0U, valueLength = 0U;
+    uint32_t currentIndex = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+
+    if( buf[ i ] == '[' )
+    {
+        i++;
+        skipSpace( buf, &i, max );
+
+        while( i < max )
+        {
+            if( currentIndex == queryIndex )
+            {
+                /* The value is not read, but must at least be present. */
+                ret = !isCloseBracket_( buf[ i ] ) && ( buf[ i ] != ',' );
+                break;
+            }
+
+            /* currentIndex is less than queryIndex, so cannot overflow. */
+            if( ( nextValue( buf, &i, max, &value, &valueLength ) != true ) ||
+                ( skipSpaceAndComma( buf, &i, max ) != true ) )
+            {
+                break;
+            }
+
+            currentIndex++;
+        }
+    }
+
+    if( ret == true )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle a nested search, without reading the value found.
+ *
+ * Same as multiSearch(), but stops at the first byte of the value found.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in] max  size of the buffer.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the query.
+ * @param[out] outValue  A pointer to receive the index of the value found.
+ *
+ * @return Same as multiSearch().
+ */
+static JSONStatus_t multiSearchStart( const char * buf,
+                                      size_t max,
+                                      const char * query,
+                                      size_t queryLength,
+                                      size_t * outValue )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U, q = 0U, key = 0U, keyLength = 0U;
+    int32_t queryIndex = -1;
+    bool found = false;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( query != NULL ) && ( outValue != NULL ) );
+    coreJSON_ASSERT( ( max > 0U ) && ( queryLength > 0U ) );
+
+    skipSpace( buf, &i, max );
+
+    while( ( ret == JSONSuccess ) && ( q < queryLength ) )
+    {
+        key = q;
+        ret = nextQueryPart( query, &q, queryLength, &keyLength, &queryIndex );
+
+        if( ret == JSONSuccess )
+        {
+            if( i == max )
+            {
+                found = false;
+            }
+            else if( queryIndex < 0 )
+            {
+                found = objectSearchStart( buf, &i, max, &query[ key ], keyLength );
+            }
+            else
+            {
+                found = arraySearchStart( buf, &i, max, ( uint32_t ) queryIndex );
+            }
+
+            if( found == false )
+            {
+                ret = JSONNotFound;
+            }
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *outValue = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Convert an integer to int64_t.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in] start  The index at which the value begins.
+ * @param[in] max  The size of the buffer.
+ * @param[out] outValue  A pointer to receive the integer.
+ *
+ * @return true if the value is an integer within the range of int64_t;
+ * false otherwise.
+ */
+static bool readInt64( const char * buf,
+                       size_t start,
+                       size_t max,
+                       int64_t * outValue )
+{
+    bool ret = false;
+    size_t i = 0U, end = 0U;
+    uint64_t n = 0U, limit = ( uint64_t ) INT64_MAX;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start < max ) && ( outValue != NULL ) );
+
+    i = start;
+    end = i;
+
+    if( skipNumber( buf, &end, max ) == true )
+    {
+        ret = ( end == max ) || isspace_( buf[ end ] ) ||
+              ( buf[ end ] == ',' ) || isCloseBracket_( buf[ end ] );
+    }
+
+    if( ( ret == true ) && ( buf[ i ] == '-' ) )
+    {
+        /* The magnitude of INT64_MIN is one more than INT64_MAX. */
+        limit++;
+        i++;
+    }
+
+    while( ( ret == true ) && ( i < end ) )
+    {
+        uint64_t digit = ( uint64_t ) buf[ i ] - ( uint64_t ) '0';
+
+        /* A fraction or exponent is not an integer. */
+        if( !isdigit_( buf[ i ] ) || ( n > ( ( limit - digit ) / 10U ) ) )
+        {
+            ret = false;
+        }
+        else
+        {
+            n = ( n * 10U ) + digit;
+            i++;
+        }
+    }
+
+    if( ret == true )
+    {
+        if( ( buf[ start ] == '-' ) && ( n > 0U ) )
+        {
+            /* Negate in unsigned arithmetic, as -INT64_MIN overflows. */
+            *outValue = -( int64_t ) ( n - 1U ) - 1;
+        }
+        else
+        {
+            *outValue = ( int64_t ) n;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check a cursor given to the public functions.
+ *
+ * @param[in] cursor  The cursor to check.
+ *
+ * @return #JSONSuccess if the cursor is within its buffer;
+ * #JSONNullParameter if the cursor or its buffer is NULL;
+ * #JSONBadParameter otherwise.
+ */
+static JSONStatus_t checkCursor( const JSONCursor_t * cursor )
+{
+    JSONStatus_t ret = JSONSuccess;
+
+    if( ( cursor == NULL ) || ( cursor->buf == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( cursor->start >= cursor->max )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Read the members of an object into a key table.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in] start  The index of the object.
+ * @param[in] max  The size of the buffer.
+ * @param[out] table  The slots, all empty.
+ * @param[in] capacity  The number of slots.
+ * @param[out] outCount  A pointer to receive the number of keys read.
+ *
+ * @return #JSONSuccess if every key was written;
+ * #JSONInsufficientMemory if a key found no empty slot;
+ * otherwise the error met while reading the object.
+ */
+static JSONStatus_t writeKeyTable( const char * buf,
+                                   size_t start,
+                                   size_t max,
+                                   JSONKeySlot_t * table,
+                                   size_t capacity,
+                                   size_t * outCount )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, key = 0U, keyLength = 0U, n = 0U, count = 0U;
+    bool full = false;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start < max ) && ( outCount != NULL ) );
+
+    i = start;
+    ret = cursorOpen( buf, &i, max, '{', '}' );
+
+    while( ret == JSONSuccess )
+    {
+        ret = cursorKey( buf, &i, max, &key, &keyLength );
+
+        if( ret == JSONSuccess )
+        {
+            count++;
+
+            /* Keep the first of a repeated key, as a search would. */
+            if( ( findKeySlot( buf, max, table, capacity, &buf[ key ], keyLength, &n ) == false ) &&
+                ( n < capacity ) )
+            {
+                table[ n ].key = key;
+                table[ n ].keyLength = keyLength;
+                table[ n ].value = i;
+            }
+            else if( n == capacity )
+            {
+                full = true;
+            }
+            else
+            {
+                /* MISRA 15.7 */
+            }
+
+            ret = skipValue( buf, &i, max );
+        }
+
+        if( ret == JSONSuccess )
+        {
+            statsAdd_( valuesScanned, 1U );
+            ret = cursorSeparator( buf, &i, max, '}' );
+        }
+    }
+
+    /* The end of the object, or an empty object. */
+    if( ret == JSONNotFound )
+    {
+        ret = ( full == true ) ? JSONInsufficientMemory : JSONSuccess;
+    }
+
+    *outCount = count;
+
+    return ret;
+}
+
+/**
+ * @brief Read the elements of an array, writing the index of each.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index of the array; receives the index past it.
+ * @param[in] max  The size of the buffer.
+ * @param[out] offsets  The array to receive the indexes, or NULL.
+ * @param[in] capacity  The number of indexes it can hold.
+ * @param[out] outCount  A pointer to receive the number of elements read.
+ *
+ * @return #JSONSuccess if every index was written;
+ * #JSONInsufficientMemory if there were more elements than @p capacity;
+ * otherwise the error met while reading the array.
+ */
+static JSONStatus_t writeArrayOffsets( const char * buf,
+                                       size_t * start,
+                                       size_t max,
+                                       size_t * offsets,
+                                       size_t capacity,
+                                       size_t * outCount )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, count = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+    coreJSON_ASSERT( ( ( offsets != NULL ) || ( capacity == 0U ) ) && ( outCount != NULL ) );
+
+    i = *start;
+    ret = cursorOpen( buf, &i, max, '[', ']' );
+
+    while( ret == JSONSuccess )
+    {
+        if( count < capacity )
+        {
+            offsets[ count ] = i;
+        }
+
+        count++;
+        ret = skipValue( buf, &i, max );
+
+        if( ret == JSONSuccess )
+        {
+            statsAdd_( valuesScanned, 1U );
+            ret = cursorSeparator( buf, &i, max, ']' );
+        }
+    }
+
+    /* The end of the array, or an empty array. */
+    if( ret == JSONNotFound )
+    {
+        /* The closing bracket follows any space after the last element,
+         * or after the opening bracket. */
+        if( count == 0U )
+        {
+            i++;
+        }
+
+        skipSpace( buf, &i, max );
+        *start = i + 1U;
+        ret = ( count > capacity ) ? JSONInsufficientMemory : JSONSuccess;
+    }
+
+    *outCount = count;
+
+    return ret;
+}
+
+/**
+ * @brief Find the wildcard index of a query.
+ *
+ * A key of a query cannot hold a square bracket, so "[*]" is always an
+ * index part.
+ *
+ * @param[in] query  The query.
+ * @param[in] queryLength  Length of the query.
+ *
+ * @return the index of the '[' of the first "[*]"; queryLength if there is none.
+ */
+static size_t findWildcard( const char * query,
+                            size_t queryLength )
+{
+    size_t i = 0U, ret = queryLength;
+
+    coreJSON_ASSERT( query != NULL );
+
+    while( ( ret == queryLength ) && ( ( i + 3U ) <= queryLength ) )
+    {
+        if( isSquareOpen_( query[ i ] ) && ( query[ i + 1U ] == '*' ) &&
+            isSquareClose_( query[ i + 2U ] ) )
+        {
+            ret = i;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check that each part of a query is well formed.
+ *
+ * @param[in] query  The query.
+ * @param[in] queryLength  Length of the query; may be 0.
+ *
+ * @return #JSONSuccess if the query is well formed;
+ * #JSONBadParameter otherwise.
+ */
+static JSONStatus_t checkQuery( const char * query,
+                                size_t queryLength )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t q = 0U, keyLength = 0U;
+    int32_t queryIndex = -1;
+
+    coreJSON_ASSERT( query != NULL );
+
+    while( ( ret == JSONSuccess ) && ( q < queryLength ) )
+    {
+        ret = nextQueryPart( query, &q, queryLength, &keyLength, &queryIndex );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Output to a callback the value matched by a query in each element
+ * of an array.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in] start  The index of the array.
+ * @param[in] max  The size of the buffer.
+ * @param[in] query  The query to follow from each element.
+ * @param[in] queryLength  Length of the query; 0 to output each element.
+ * @param[in] callback  The function to receive each value matched.
+ * @param[in] context  Passed to @p callback.
+ *
+ * @return #JSONSuccess if the array ends, or the callback stops the pass;
+ * otherwise the error met while reading the array.
+ */
+static JSONStatus_t eachElement( const char * buf,
+                                 size_t start,
+                                 size_t max,
+                                 const char * query,
+                                 size_t queryLength,
+                                 JSONMatchCallback_t callback,
+                                 void * context )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, value = 0U;
+    bool more = true;
+    JSONCursor_t match;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start < max ) );
+    coreJSON_ASSERT( ( query != NULL ) && ( callback != NULL ) );
+
+    i = start;
+    ret = cursorOpen( buf, &i, max, '[', ']' );
+
+    while( ( ret == JSONSuccess ) && ( more == true ) )
+    {
+        value = i;
+
+        if( queryLength > 0U )
+        {
+            ret = cursorSearch( buf, &value, max, query, queryLength, NULL );
+        }
+
+        if( ret == JSONSuccess )
+        {
+            match.buf = buf;
+            match.max = max;
+            match.start = value;
+            more = callback( context, &match );
+        }
+
+        /* An element that does not match is passed over, as is one that does. */
+        if( ( more == true ) && ( ( ret == JSONSuccess ) || ( ret == JSONNotFound ) ) )
+        {
+            ret = skipValue( buf, &i, max );
+
+            if( ret == JSONSuccess )
+            {
+                statsAdd_( valuesScanned, 1U );
+                ret = cursorSeparator( buf, &i, max, ']' );
+            }
+        }
+    }
+
+    /* The array has ended. */
+    if( ret == JSONNotFound )
+    {
+        ret = JSONSuccess;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance buffer index beyond an array element, checking that it
+ * is delimited as one.
+ *
+ * The element must follow '[' or ',', and be followed by ',' or ']', in
+ * each case allowing whitespace between them.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which the element begins.
+ * @param[in] max  The size of the buffer.
+ *
+ * @return #JSONIllegalDocument if the element is not delimited as one;
+ * #JSONPartial if the buffer ends before the byte that follows it;
+ * otherwise the same as skipValue().
+ */
+static JSONStatus_t skipElement( const char * buf,
+                                 size_t * start,
+                                 size_t max )
+{
+    JSONStatus_t ret = JSONIllegalDocument;
+    size_t i = 0U, end = 0U;
+
+    coreJSON_ASSERT( ( buf != NULL ) && ( start != NULL ) && ( *start < max ) );
+
+    i = *start;
+
+    while( ( i > 0U ) && isspace_( buf[ i - 1U ] ) )
+    {
+        i--;
+    }
+
+    if( ( i > 0U ) && ( ( buf[ i - 1U ] == '[' ) || ( buf[ i - 1U ] == ',' ) ) )
+    {
+        i = *start;
+        ret = skipValue( buf, &i, max );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        end = i;
+        skipSpace( buf, &i, max );
+
+        if( i == max )
+        {
+            ret = JSONPartial;
+        }
+        else if( ( buf[ i ] != ',' ) && ( buf[ i ] != ']' ) )
+        {
+            ret = JSONIllegalDocument;
+        }
+        else
+        {
+            *start = end;
+        }
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_DocOpen( const char * buf,
+                           size_t max,
+                           JSONCursor_t * outCursor )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U;
+
+    if( ( buf == NULL ) || ( outCursor == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        skipSpace( buf, &i, max );
+
+        if( i == max )
+        {
+            ret = JSONPartial;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        outCursor->buf = buf;
+        outCursor->max = max;
+        outCursor->start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_ObjectFind( const JSONCursor_t * object,
+                              const char * key,
+                              size_t keyLength,
+                              JSONCursor_t * outValue )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    ret = checkCursor( object );
+
+    if( ( ret == JSONSuccess ) && ( ( key == NULL ) || ( outValue == NULL ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+
+    if( ret == JSONSuccess )
+    {
+        i = object->start;
+        ret = cursorFind( object->buf, &i, object->max, key, keyLength, NULL );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        outValue->buf = object->buf;
+        outValue->max = object->max;
+        outValue->start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_ArrayNext( const JSONCursor_t * array,
+                             JSONCursor_t * element )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    ret = checkCursor( array );
+
+    if( ( ret == JSONSuccess ) && ( element == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( ret == JSONSuccess ) && ( element->start >= array->max ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        i = element->start;
+
+        /* A zeroed element, or one from before the array, begins the iteration. */
+        if( i <= array->start )
+        {
+            i = array->start;
+            ret = cursorOpen( array->buf, &i, array->max, '[', ']' );
+        }
+        else
+        {
+            ret = skipValue( array->buf, &i, array->max );
+
+            if( ret == JSONSuccess )
+            {
+                statsAdd_( valuesScanned, 1U );
+                ret = cursorSeparator( array->buf, &i, array->max, ']' );
+            }
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        element->buf = array->buf;
+        element->max = array->max;
+        element->start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_SearchFrom( const JSONCursor_t * cursor,
+                              const char * query,
+                              size_t queryLength,
+                              JSONCursor_t * outValue )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    ret = checkCursor( cursor );
+
+    if( ( ret == JSONSuccess ) && ( ( query == NULL ) || ( outValue == NULL ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( ret == JSONSuccess ) && ( queryLength == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        statsQuery_( cursor->max - cursor->start );
+        i = cursor->start;
+        ret = cursorSearch( cursor->buf, &i, cursor->max, query, queryLength, NULL );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        outValue->buf = cursor->buf;
+        outValue->max = cursor->max;
+        outValue->start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_SearchEach( const JSONCursor_t * cursor,
+                              const char * query,
+                              size_t queryLength,
+                              JSONMatchCallback_t callback,
+                              void * context )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, wildcard = 0U, rest = 0U;
+    JSONCursor_t match;
+
+    ret = checkCursor( cursor );
+
+    if( ( ret == JSONSuccess ) && ( ( query == NULL ) || ( callback == NULL ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( ret == JSONSuccess ) && ( queryLength == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        /* Split the query about its wildcard, and check both parts before
+         * reading, as the rest may otherwise never be reached. */
+        wildcard = findWildcard( query, queryLength );
+        rest = ( wildcard < queryLength ) ? ( wildcard + 3U ) : queryLength;
+
+        if( ( rest < queryLength ) && isSeparator_( query[ rest ] ) )
+        {
+            rest++;
+            ret = ( rest < queryLength ) ? JSONSuccess : JSONBadParameter;
+        }
+
+        if( ret == JSONSuccess )
+        {
+            ret = checkQuery( query, wildcard );
+        }
+
+        if( ret == JSONSuccess )
+        {
+            ret = checkQuery( &query[ rest ], queryLength - rest );
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        statsQuery_( cursor->max - cursor->start );
+        i = cursor->start;
+
+        if( wildcard > 0U )
+        {
+            ret = cursorSearch( cursor->buf, &i, cursor->max, query, wildcard, NULL );
+        }
+    }
+
+    if( ret != JSONSuccess )
+    {
+        /* The part before the wildcard is not matched. */
+    }
+    else if( wildcard == queryLength )
+    {
+        match.buf = cursor->buf;
+        match.max = cursor->max;
+        match.start = i;
+        ( void ) callback( context, &match );
+    }
+    else if( isSquareOpen_( cursor->buf[ i ] ) )
+    {
+        ret = eachElement( cursor->buf, i, cursor->max, &query[ rest ], queryLength - rest,
+                           callback, context );
+    }
+    else
+    {
+        ret = JSONNotFound;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_GetValue( const JSONCursor_t * cursor,
+                            const char ** outValue,
+                            size_t * outValueLength,
+                            JSONTypes_t * outType )
+{
+    JSONStatus_t ret;
+    size_t value = 0U, end = 0U;
+    JSONTypes_t t = JSONInvalid;
+
+    ret = checkCursor( cursor );
+
+    if( ( ret == JSONSuccess ) && ( ( outValue == NULL ) || ( outValueLength == NULL ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+
+    if( ret == JSONSuccess )
+    {
+        value = cursor->start;
+        end = value;
+        ret = skipValue( cursor->buf, &end, cursor->max );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        t = getType( cursor->buf[ value ] );
+
+        if( t == JSONString )
+        {
+            /* strip the surrounding quotes */
+            value++;
+            end--;
+        }
+
+        *outValue = &cursor->buf[ value ];
+        *outValueLength = end - value;
+
+        if( outType != NULL )
+        {
+            *outType = t;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_GetInt64( const JSONCursor_t * cursor,
+                            int64_t * outValue )
+{
+    JSONStatus_t ret;
+
+    ret = checkCursor( cursor );
+
+    if( ( ret == JSONSuccess ) && ( outValue == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+
+    if( ret == JSONSuccess )
+    {
+        if( readInt64( cursor->buf, cursor->start, cursor->max, outValue ) != true )
+        {
+            ret = JSONIllegalDocument;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_ValidateAndIndex( const char * buf,
+                                    size_t max,
+                                    JSONIndexEntry_t * index,
+                                    size_t indexCapacity,
+                                    size_t * outIndexCount )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+    indexWriter_t w;
+
+    w.entries = index;
+    w.capacity = indexCapacity;
+    w.count = 0U;
+
+    if( ( buf == NULL ) || ( outIndexCount == NULL ) ||
+        ( ( index == NULL ) && ( indexCapacity > 0U ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        ret = indexValue( buf, &i, max, &w );
+    }
+
+    if( ( ret == JSONSuccess ) && ( i < max ) )
+    {
+        skipSpace( buf, &i, max );
+
+        if( i != max )
+        {
+            ret = JSONIllegalDocument;
+        }
+    }
+
+    if( ( ret == JSONSuccess ) && ( w.count > indexCapacity ) )
+    {
+        ret = JSONInsufficientMemory;
+    }
+
+    if( outIndexCount != NULL )
+    {
+        *outIndexCount = w.count;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_SearchIndexed( const char * buf,
+                                 size_t max,
+                                 const JSONIndexEntry_t * index,
+                                 size_t indexCount,
+                                 const char * query,
+                                 size_t queryLength,
+                                 const char ** outValue,
+                                 size_t * outValueLength,
+                                 JSONTypes_t * outType )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t value = 0U, end = 0U;
+    skipContext_t ctx;
+
+    ctx.index = index;
+    ctx.count = indexCount;
+    ctx.trusted = false;
+
+    if( ( buf == NULL ) || ( query == NULL ) ||
+        ( outValue == NULL ) || ( outValueLength == NULL ) ||
+        ( ( index == NULL ) && ( indexCount > 0U ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( max == 0U ) || ( queryLength == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        statsQuery_( max );
+        skipSpace( buf, &value, max );
+
+        if( value == max )
+        {
+            ret = JSONPartial;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        ret = cursorSearch( buf, &value, max, query, queryLength, &ctx );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        end = value;
+        ret = skipMember( buf, &end, max, &ctx );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        JSONTypes_t t = getType( buf[ value ] );
+
+        if( t == JSONString )
+        {
+            /* strip the surrounding quotes */
+            value++;
+            end--;
+        }
+
+        *outValue = &buf[ value ];
+        *outValueLength = end - value;
+
+        if( outType != NULL )
+        {
+            *outType = t;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_KeyIndexBuild( const JSONCursor_t * object,
+                                 JSONKeySlot_t * table,
+                                 size_t tableCapacity,
+                                 size_t * outKeyCount )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    ret = checkCursor( object );
+
+    if( ( ret == JSONSuccess ) && ( ( table == NULL ) || ( outKeyCount == NULL ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( ret == JSONSuccess ) && ( tableCapacity == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        for( i = 0U; i < tableCapacity; i++ )
+        {
+            table[ i ].key = 0U;
+            table[ i ].keyLength = 0U;
+            table[ i ].value = 0U;
+        }
+
+        ret = writeKeyTable( object->buf, object->start, object->max,
+                             table, tableCapacity, outKeyCount );
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_KeyIndexFind( const JSONCursor_t * object,
+                                const JSONKeySlot_t * table,
+                                size_t tableCapacity,
+                                const char * key,
+                                size_t keyLength,
+                                JSONCursor_t * outValue )
+{
+    JSONStatus_t ret;
+    size_t n = 0U;
+
+    ret = checkCursor( object );
+
+    if( ( ret == JSONSuccess ) &&
+        ( ( table == NULL ) || ( key == NULL ) || ( outValue == NULL ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( ret == JSONSuccess ) && ( tableCapacity == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        /* MISRA 15.7 */
+    }
+
+    if( ret == JSONSuccess )
+    {
+        if( findKeySlot( object->buf, object->max, table, tableCapacity,
+                         key, keyLength, &n ) == true )
+        {
+            outValue->buf = object->buf;
+            outValue->max = object->max;
+            outValue->start = table[ n ].value;
+        }
+        else
+        {
+            ret = JSONNotFound;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_ArrayIndexBuild( const char * buf,
+                                   size_t max,
+                                   size_t * offsets,
+                                   size_t offsetsCapacity,
+                                   size_t * outCount )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U;
+
+    if( ( buf == NULL ) || ( outCount == NULL ) ||
+        ( ( offsets == NULL ) && ( offsetsCapacity > 0U ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        *outCount = 0U;
+        skipSpace( buf, &i, max );
+
+        if( i == max )
+        {
+            ret = JSONPartial;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        ret = writeArrayOffsets( buf, &i, max, offsets, offsetsCapacity, outCount );
+    }
+
+    if( ( ( ret == JSONSuccess ) || ( ret == JSONInsufficientMemory ) ) && ( i < max ) )
+    {
+        skipSpace( buf, &i, max );
+
+        if( i != max )
+        {
+            ret = JSONIllegalDocument;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_ArrayAt( const char * buf,
+                           size_t max,
+                           const size_t * offsets,
+                           size_t count,
+                           size_t elementIndex,
+                           const char ** outValue,
+                           size_t * outValueLength,
+                           JSONTypes_t * outType )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t value = 0U, end = 0U;
+    JSONTypes_t t = JSONInvalid;
+
+    if( ( buf == NULL ) || ( outValue == NULL ) || ( outValueLength == NULL ) ||
+        ( ( offsets == NULL ) && ( count > 0U ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else if( elementIndex >= count )
+    {
+        ret = JSONNotFound;
+    }
+    else if( offsets[ elementIndex ] >= max )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        value = offsets[ elementIndex ];
+        end = value;
+        ret = skipElement( buf, &end, max );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        t = getType( buf[ value ] );
+
+        if( t == JSONString )
+        {
+            /* strip the surrounding quotes */
+            value++;
+            end--;
+        }
+
+        *outValue = &buf[ value ];
+        *outValueLength = end - value;
+
+        if( outType != NULL )
+        {
+            *outType = t;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_Count( const char * buf,
+                         size_t max,
+                         size_t * outCount )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U;
+
+    if( ( buf == NULL ) || ( outCount == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( max == 0U )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        skipSpace( buf, &i, max );
+
+        if( i == max )
+        {
+            ret = JSONPartial;
+        }
+        else if( !isOpenBracket_( buf[ i ] ) )
+        {
+            ret = JSONIllegalDocument;
+        }
+        else
+        {
+            ret = countMembers( buf, &i, max, outCount );
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_SearchTrusted( const char * buf,
+                                 size_t max,
+                                 const char * query,
+                                 size_t queryLength,
+                                 const char ** outValue,
+                                 size_t * outValueLength,
+                                 JSONTypes_t * outType )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U, end = 0U;
+    skipContext_t ctx;
+
+    if( ( buf == NULL ) || ( query == NULL ) ||
+        ( outValue == NULL ) || ( outValueLength == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( max == 0U ) || ( queryLength == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        statsQuery_( max );
+
+        ctx.index = NULL;
+        ctx.count = 0U;
+        ctx.trusted = true;
+
+        skipSpace( buf, &i, max );
+
+        if( i == max )
+        {
+            ret = JSONNotFound;
+        }
+        else
+        {
+            ret = cursorSearch( buf, &i, max, query, queryLength, &ctx );
+        }
+
+        end = i;
+
+        if( ( ret == JSONSuccess ) && ( skipTrusted( buf, &end, max ) != true ) )
+        {
+            ret = JSONPartial;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        JSONTypes_t t = getType( buf[ i ] );
+
+        *outValueLength = end - i;
+
+        if( t == JSONString )
+        {
+            /* strip the surrounding quotes */
+            i++;
+            *outValueLength -= 2U;
+        }
+
+        *outValue = &buf[ i ];
+
+        if( outType != NULL )
+        {
+            *outType = t;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_SearchStart( const char * buf,
+                               size_t max,
+                               const char * query,
+                               size_t queryLength,
+                               const char ** outValue,
+                               JSONTypes_t * outType )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0U;
+
+    if( ( buf == NULL ) || ( query == NULL ) || ( outValue == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( max == 0U ) || ( queryLength == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        statsQuery_( max );
+
+        /* The values passed over are validated; the value found is not read. */
+        ret = multiSearchStart( buf, max, query, queryLength, &i );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *outValue = &buf[ i ];
+
+        if( outType != NULL )
+        {
+            *outType = getType( buf[ i ] );
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_Exists( const char * buf,
+                          size_t max,
+                          const char * query,
+                          size_t queryLength )
+{
+    const char * value;
+
+    return JSON_SearchStart( buf, max, query, queryLength, &value, NULL );
+}
+
+#ifdef JSON_ENABLE_STATS
+
+/**
+ * See core_json.h for docs.
+ */
+    void JSON_SetStats( JSONStats_t * stats )
+    {
+        statsTarget = stats;
+    }
+
+#endif /* ifdef JSON_ENABLE_STATS */
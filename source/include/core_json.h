@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -65,13 +66,14 @@
  */
 typedef enum
 {
-    JSONPartial = 0,      /**< @brief JSON document is valid so far but incomplete. */
-    JSONSuccess,          /**< @brief JSON document is valid and complete. */
-    JSONIllegalDocument,  /**< @brief JSON document is invalid or malformed. */
-    JSONMaxDepthExceeded, /**< @brief JSON document has nesting that exceeds JSON_MAX_DEPTH. */
-    JSONNotFound,         /**< @brief Query key could not be found in the JSON document. */
-    JSONNullParameter,    /**< @brief Pointer parameter passed to a function is NULL. */
-    JSONBadParameter      /**< @brief Query key is empty, or any subpart is empty, or max is 0. */
+    JSONPartial = 0,       /**< @brief JSON document is valid so far but incomplete. */
+    JSONSuccess,           /**< @brief JSON document is valid and complete. */
+    JSONIllegalDocument,   /**< @brief JSON document is invalid or malformed. */
+    JSONMaxDepthExceeded,  /**< @brief JSON document has nesting that exceeds JSON_MAX_DEPTH. */
+    JSONNotFound,          /**< @brief Query key could not be found in the JSON document. */
+    JSONNullParameter,     /**< @brief Pointer parameter passed to a function is NULL. */
+    JSONBadParameter,      /**< @brief Query key is empty, or any subpart is empty, or max is 0. */
+    JSONInsufficientMemory /**< @brief An output buffer is too small to hold the result. */
 } JSONStatus_t;
 
 /**
@@ -350,6 +352,1136 @@ JSONStatus_t JSON_Iterate( const char * buf,
                            JSONPair_t * outPair );
 /* @[declare_json_iterate] */
 
+/**
+ * @ingroup json_struct_types
+ * @brief One slot of a table of the keys of an object.
+ */
+typedef struct
+{
+    size_t key;       /**< @brief Index of the key, after its quote; 0 if the slot is empty. */
+    size_t keyLength; /**< @brief Length of the key. */
+    size_t value;     /**< @brief Index at which the value of the key begins. */
+} JSONKeySlot_t;
+
+/**
+ * @brief Apply an RFC 7396 JSON Merge Patch to a target document.
+ *
+ * The merged document is written to @p out.  Following RFC 7396, when the
+ * patch is an object each of its members is merged into the target object:
+ * a null value removes the key, an object value is merged recursively, and
+ * any other value replaces the target value.  A patch that is not an object
+ * replaces the target entirely.
+ *
+ * The target is read once from start to end.  Members of the target keep
+ * their order and formatting; members only present in the patch are appended
+ * to the end of the enclosing object.  Keys are compared byte for byte, as
+ * they are by JSON_Search().  Where a key is repeated in a patch object, the
+ * last member with the key is applied, and a key is written at most once.
+ *
+ * The keys of each patch object being merged are hashed into a table in
+ * @p scratch, so that each object of the target and of the patch is read a
+ * fixed number of times, however many members it has.  The table of an
+ * object uses two slots per member, and is kept while its nested objects are
+ * merged.  Slots for twice the number of members in the patch, counting
+ * those of nested objects, are therefore always enough.  A patch without
+ * members needs no slots.
+ *
+ * @param[in] target  The document to patch.
+ * @param[in] targetLength  The size of the target buffer.
+ * @param[in] patch  The merge patch to apply.
+ * @param[in] patchLength  The size of the patch buffer.
+ * @param[out] scratch  The slots in which to record the keys of the patch.
+ * @param[in] scratchCapacity  The number of slots.
+ * @param[out] out  The buffer to receive the merged document.
+ * @param[in] outCapacity  The size of the output buffer.
+ * @param[out] outLength  A pointer to receive the length of the merged document.
+ *
+ * @note This function expects valid JSON documents; run JSON_Validate() first.
+ *
+ * @note Nested objects in the patch are tracked on the stack, up to a depth
+ * of JSON_MAX_DEPTH, using three indexes and a flag per object.
+ *
+ * @return #JSONSuccess if the merged document is output;
+ * #JSONNullParameter if any pointer parameters are NULL, other than
+ * @p scratch when @p scratchCapacity is 0;
+ * #JSONBadParameter if any length is 0;
+ * #JSONIllegalDocument if the patch does not contain a value, or an object
+ * of the patch is malformed or does not end;
+ * #JSONMaxDepthExceeded if object nesting in the patch exceeds JSON_MAX_DEPTH;
+ * #JSONInsufficientMemory if the output buffer is too small, in which case
+ * @p outLength receives the size required, or if there are too few scratch
+ * slots, in which case @p outLength receives 0.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char target[] = "{\"a\":\"b\",\"c\":{\"d\":\"e\",\"f\":\"g\"}}";
+ *     char patch[] = "{\"a\":\"z\",\"c\":{\"f\":null}}";
+ *     JSONKeySlot_t scratch[ 6 ];
+ *     char out[ 32 ];
+ *     size_t outLength;
+ *
+ *     // The patch has three members, so six slots are enough.
+ *     result = JSON_MergePatch( target, sizeof( target ) - 1,
+ *                               patch, sizeof( patch ) - 1,
+ *                               scratch, 6, out, sizeof( out ), &outLength );
+ *
+ *     // The merged document is {"a":"z","c":{"d":"e"}}
+ *     assert( result == JSONSuccess );
+ * @endcode
+ */
+/* @[declare_json_mergepatch] */
+JSONStatus_t JSON_MergePatch( const char * target,
+                              size_t targetLength,
+                              const char * patch,
+                              size_t patchLength,
+                              JSONKeySlot_t * scratch,
+                              size_t scratchCapacity,
+                              char * out,
+                              size_t outCapacity,
+                              size_t * outLength );
+/* @[declare_json_mergepatch] */
+
+/**
+ * @brief Remove insignificant whitespace from a JSON document in place.
+ *
+ * Whitespace outside of strings is dropped and the remaining bytes are moved
+ * toward the start of the buffer.  A run of whitespace between two literal or
+ * number characters is kept as a single space, so that tokens are never
+ * joined.  Strings are copied unchanged; they are scanned with the same rules
+ * as JSON_Validate(), so a malformed string is reported rather than copied.
+ *
+ * @param[in,out] buf  The buffer to minify.
+ * @param[in] max  The size of the buffer.
+ * @param[out] outLength  A pointer to receive the length of the minified document.
+ *
+ * @note Only strings are checked.  The minified output is a valid document
+ * exactly when the input was, so JSON_Validate() may be run on the output
+ * instead, which is cheaper than on the input.
+ *
+ * @note When #JSONIllegalDocument is returned, the buffer has been partially
+ * minified and its contents should be discarded.
+ *
+ * @return #JSONSuccess if the document was minified;
+ * #JSONNullParameter if any pointer parameters are NULL;
+ * #JSONBadParameter if max is 0;
+ * #JSONIllegalDocument if a string in the buffer is malformed.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char buffer[] = "{\n  \"foo\": \"a b\",\n  \"bar\": [ 1, 2 ]\n}";
+ *     size_t length;
+ *
+ *     result = JSON_Minify( buffer, sizeof( buffer ) - 1, &length );
+ *
+ *     // The first length bytes of buffer are {"foo":"a b","bar":[1,2]}
+ *     assert( result == JSONSuccess );
+ * @endcode
+ */
+/* @[declare_json_minify] */
+JSONStatus_t JSON_Minify( char * buf,
+                          size_t max,
+                          size_t * outLength );
+/* @[declare_json_minify] */
+
+/**
+ * @brief Find the next record in a stream of newline-delimited JSON
+ * documents (JSON Lines / NDJSON).
+ *
+ * Records are separated by '\n'.  Lines holding only whitespace are skipped.
+ * Each record is validated as with JSON_Validate(), and its result is
+ * output in @p outRecordStatus; a malformed record does not stop the
+ * stream, as the next call resumes at the following line.
+ *
+ * @param[in] buf  The buffer holding the stream.
+ * @param[in] max  Size of the buffer.
+ * @param[in,out] offset  The offset at which to resume; set to 0 to start,
+ * and updated to the start of the following line.
+ * @param[out] outRecordStart  A pointer to receive the offset of the record,
+ * after any leading whitespace.
+ * @param[out] outRecordLength  A pointer to receive the length of the record,
+ * excluding the terminating '\n'.
+ * @param[out] outRecordStatus  A pointer to receive the result of validating
+ * the record.  #JSONPartial is output only for a final record without a
+ * terminating '\n', which may be completed by more data; a terminated record
+ * that is incomplete is output as #JSONIllegalDocument.
+ *
+ * @return #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if *offset is greater than max;
+ * #JSONNotFound if no record remains;
+ * #JSONSuccess if a record was found.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result, recordStatus;
+ *     char buffer[] = "{\"a\":1}\n\n{\"a\":\n[2]\n";
+ *     size_t offset = 0, start, length, valid = 0, invalid = 0;
+ *
+ *     while( JSON_NextRecord( buffer, sizeof( buffer ) - 1, &offset,
+ *                             &start, &length, &recordStatus ) == JSONSuccess )
+ *     {
+ *         if( recordStatus == JSONSuccess )
+ *         {
+ *             valid++;
+ *         }
+ *         else
+ *         {
+ *             invalid++;
+ *         }
+ *     }
+ *
+ *     // valid == 2, invalid == 1
+ * @endcode
+ */
+/* @[declare_json_nextrecord] */
+JSONStatus_t JSON_NextRecord( const char * buf,
+                              size_t max,
+                              size_t * offset,
+                              size_t * outRecordStart,
+                              size_t * outRecordLength,
+                              JSONStatus_t * outRecordStatus );
+/* @[declare_json_nextrecord] */
+
+/**
+ * @brief Validate the first JSON value in a buffer, ignoring what follows.
+ *
+ * Unlike JSON_Validate(), the value may be followed by other bytes, such as
+ * further documents in a stream of concatenated documents.  The number of
+ * bytes taken by the value, including leading whitespace, is output so the
+ * caller can resume at the next document.
+ *
+ * @param[in] buf  The buffer to validate.
+ * @param[in] max  Size of the buffer.
+ * @param[out] outConsumed  A pointer to receive the index just past the value.
+ *
+ * @return #JSONSuccess if the buffer begins with a valid value;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if max is 0;
+ * #JSONPartial if the buffer ends before the value does;
+ * #JSONIllegalDocument if the value is invalid;
+ * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold.
+ *
+ * @note A scalar ends where its syntax ends, so a number at the end of the
+ * buffer is taken as complete even if more digits may follow in the stream.
+ * Streams of concatenated numbers need a delimiter to be unambiguous.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char buffer[] = "{\"foo\":1}{\"foo\":2} [3]";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     size_t start = 0, consumed;
+ *
+ *     do
+ *     {
+ *         result = JSON_ValidatePrefix( &buffer[ start ], bufferLength - start,
+ *                                       &consumed );
+ *
+ *         if( result == JSONSuccess )
+ *         {
+ *             // The next document ends at start + consumed.
+ *             start += consumed;
+ *         }
+ *     } while( ( result == JSONSuccess ) && ( start < bufferLength ) );
+ * @endcode
+ */
+/* @[declare_json_validateprefix] */
+JSONStatus_t JSON_ValidatePrefix( const char * buf,
+                                  size_t max,
+                                  size_t * outConsumed );
+/* @[declare_json_validateprefix] */
+
+/**
+ * @ingroup json_struct_types
+ * @brief A position within a document that is read on demand.
+ *
+ * A cursor marks the first byte of a value.  Nothing after that byte has
+ * been validated; the value is checked only as far as it is read or
+ * skipped, and errors are reported by the call that reaches them.
+ * The members are set by the library and should be treated as read-only.
+ */
+typedef struct
+{
+    const char * buf; /**< @brief Pointer to the document. */
+    size_t max;       /**< @brief Length of the document. */
+    size_t start;     /**< @brief Index at which the value begins. */
+} JSONCursor_t;
+
+/**
+ * @brief Open a document for reading on demand.
+ *
+ * Only leading whitespace is read.  Fields are then reached with
+ * JSON_ObjectFind() and JSON_ArrayNext(), and read with JSON_GetValue()
+ * or JSON_GetInt64().  Together these validate only the bytes they pass
+ * over, so the cost is bounded by what the application reads rather than
+ * by the size of the document.  Unlike JSON_Validate(), they do not check
+ * anything beyond the last value read.
+ *
+ * @param[in] buf  The buffer to read.
+ * @param[in] max  size of the buffer.
+ * @param[out] outCursor  A pointer to receive a cursor at the top-level value.
+ *
+ * @return #JSONSuccess if the cursor is output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if max is 0;
+ * #JSONPartial if the buffer holds only whitespace.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     JSONCursor_t doc, state, version;
+ *     char buffer[] = "{\"version\":3,\"state\":{\"items\":[1,2]},\"rest\":[]}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     int64_t number;
+ *
+ *     result = JSON_DocOpen( buffer, bufferLength, &doc );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_ObjectFind( &doc, "version", 7, &version );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_GetInt64( &version, &number );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_ObjectFind( &doc, "state", 5, &state );
+ *     }
+ *
+ *     // number == 3, and "rest" has not been read.
+ * @endcode
+ */
+/* @[declare_json_docopen] */
+JSONStatus_t JSON_DocOpen( const char * buf,
+                           size_t max,
+                           JSONCursor_t * outCursor );
+/* @[declare_json_docopen] */
+
+/**
+ * @brief Find a key of an object read on demand.
+ *
+ * The keys of the object are compared in order, and the values before the
+ * match are skipped and validated.  The value found is not read.  As with
+ * JSON_SearchConst(), keys are compared byte for byte, without decoding
+ * escape sequences.
+ *
+ * @param[in] object  A cursor at an object.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ * @param[out] outValue  A pointer to receive a cursor at the value found.
+ *
+ * @return #JSONSuccess if the key is found and the cursor output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer;
+ * #JSONNotFound if the object does not hold the key;
+ * #JSONIllegalDocument if the cursor is not at an object, or the bytes read
+ * are not valid JSON;
+ * #JSONMaxDepthExceeded if a value skipped has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the key or the object does.
+ */
+/* @[declare_json_objectfind] */
+JSONStatus_t JSON_ObjectFind( const JSONCursor_t * object,
+                              const char * key,
+                              size_t keyLength,
+                              JSONCursor_t * outValue );
+/* @[declare_json_objectfind] */
+
+/**
+ * @brief Step through the elements of an array read on demand.
+ *
+ * Zero the element cursor before the first call.  Each call then skips
+ * and validates the element it was given, and outputs the next one.
+ *
+ * @param[in] array  A cursor at an array.
+ * @param[in,out] element  A zeroed cursor, or the element from the last call.
+ *
+ * @return #JSONSuccess if the next element is output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if either cursor is not within the buffer of the array;
+ * #JSONNotFound if there are no further elements;
+ * #JSONIllegalDocument if the cursor is not at an array, or the bytes read
+ * are not valid JSON;
+ * #JSONMaxDepthExceeded if an element skipped has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the array does.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONCursor_t array, element = { 0 };
+ *     int64_t number, sum = 0;
+ *
+ *     // Where array was output by JSON_ObjectFind().
+ *     while( JSON_ArrayNext( &array, &element ) == JSONSuccess )
+ *     {
+ *         if( JSON_GetInt64( &element, &number ) == JSONSuccess )
+ *         {
+ *             sum += number;
+ *         }
+ *     }
+ * @endcode
+ */
+/* @[declare_json_arraynext] */
+JSONStatus_t JSON_ArrayNext( const JSONCursor_t * array,
+                             JSONCursor_t * element );
+/* @[declare_json_arraynext] */
+
+/**
+ * @brief Follow a query from a value read on demand.
+ *
+ * The query is that of JSON_SearchConst(), taken relative to the value at
+ * the cursor, and is followed as JSON_ObjectFind() and JSON_ArrayNext()
+ * would: the values passed over are skipped and validated, and the value
+ * found is not read.  Several queries under a common prefix may so be
+ * made from a cursor at the prefix, without reading the prefix again.
+ *
+ * @param[in] cursor  A cursor at the value to search, e.g. output by
+ * JSON_DocOpen() or by an earlier search.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the query.
+ * @param[out] outValue  A pointer to receive a cursor at the value found;
+ * may be the same as @p cursor.
+ *
+ * @return #JSONSuccess if the query is matched and the cursor output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer, or the query
+ * is empty or malformed;
+ * #JSONNotFound if a key or index is not present, or a value is not of the
+ * type the query expects;
+ * #JSONIllegalDocument if the bytes read are not valid JSON;
+ * #JSONMaxDepthExceeded if a value skipped has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the value found.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     JSONCursor_t doc, reported, value;
+ *     int64_t number;
+ *
+ *     result = JSON_DocOpen( buffer, bufferLength, &doc );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchFrom( &doc, "state.reported", 14, &reported );
+ *     }
+ *
+ *     // Each of these begins at "reported", rather than at the top.
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchFrom( &reported, "sensors.s1.value", 16, &value );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_GetInt64( &value, &number );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_searchfrom] */
+JSONStatus_t JSON_SearchFrom( const JSONCursor_t * cursor,
+                              const char * query,
+                              size_t queryLength,
+                              JSONCursor_t * outValue );
+/* @[declare_json_searchfrom] */
+
+/**
+ * @ingroup json_callback_types
+ * @brief A function to receive each value matched by JSON_SearchEach().
+ *
+ * @param[in] context  The context given to JSON_SearchEach().
+ * @param[in] value  A cursor at the value matched; valid only for the call.
+ *
+ * @return true to continue the search; false to stop it.
+ */
+typedef bool ( * JSONMatchCallback_t )( void * context,
+                                        const JSONCursor_t * value );
+
+/**
+ * @brief Follow a query with a wildcard index through each element of an
+ * array, in a single pass.
+ *
+ * The query is that of JSON_SearchFrom(), but may hold one "[*]" in place
+ * of an index, e.g. "items[*].id".  The part before the wildcard is
+ * followed to an array, and the part after it, if any, from each element
+ * in turn.  Each value matched is given to @p callback in document order;
+ * elements that do not hold the rest of the query are passed over.  A
+ * query without a wildcard gives its one value, if matched.
+ *
+ * Each element is read once as it is passed over, after the bytes that
+ * lead to its match, so the cost is linear in the size of the array,
+ * rather than that of a search by index for each element.  As with
+ * JSON_SearchFrom(), the values passed over are validated, and the values
+ * matched are not read.
+ *
+ * @param[in] cursor  A cursor at the value to search, e.g. output by
+ * JSON_DocOpen().
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the query.
+ * @param[in] callback  The function to receive each value matched.
+ * @param[in] context  Passed to @p callback; may be NULL.
+ *
+ * @return #JSONSuccess if the array is read to its end, or the callback
+ * stops the search;
+ * #JSONNullParameter if any pointer other than @p context is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer, or the query
+ * is empty or malformed, or holds more than one wildcard;
+ * #JSONNotFound if the part before the wildcard is not matched, or the value
+ * it matches is not an array;
+ * #JSONIllegalDocument if the bytes read are not valid JSON;
+ * #JSONMaxDepthExceeded if a value skipped has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the array does.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // A callback that sums the integers matched.
+ *     static bool addValue( void * context,
+ *                           const JSONCursor_t * value )
+ *     {
+ *         int64_t number;
+ *
+ *         if( JSON_GetInt64( value, &number ) == JSONSuccess )
+ *         {
+ *             *( int64_t * ) context += number;
+ *         }
+ *
+ *         return true;
+ *     }
+ *
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     JSONCursor_t doc;
+ *     char buffer[] = "{\"items\":[{\"id\":1},{\"id\":2},{\"name\":\"x\"}]}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     int64_t sum = 0;
+ *
+ *     result = JSON_DocOpen( buffer, bufferLength, &doc );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchEach( &doc, "items[*].id", 11, addValue, &sum );
+ *     }
+ *
+ *     // sum == 3
+ * @endcode
+ */
+/* @[declare_json_searcheach] */
+JSONStatus_t JSON_SearchEach( const JSONCursor_t * cursor,
+                              const char * query,
+                              size_t queryLength,
+                              JSONMatchCallback_t callback,
+                              void * context );
+/* @[declare_json_searcheach] */
+
+/**
+ * @brief Read the value at a cursor.
+ *
+ * The value is validated in full.  As with JSON_SearchConst(), a string
+ * is output without its surrounding quotes, and a collection is output
+ * as its JSON text.
+ *
+ * @param[in] cursor  A cursor at the value.
+ * @param[out] outValue  A pointer to receive the address of the value.
+ * @param[out] outValueLength  A pointer to receive the length of the value.
+ * @param[out] outType  An enum indicating the JSON-specific type of the value;
+ * may be NULL.
+ *
+ * @return #JSONSuccess if the value is valid and output;
+ * #JSONNullParameter if any required pointer is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer;
+ * #JSONIllegalDocument if the value is not valid JSON;
+ * #JSONMaxDepthExceeded if the value has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the value does.
+ */
+/* @[declare_json_getvalue] */
+JSONStatus_t JSON_GetValue( const JSONCursor_t * cursor,
+                            const char ** outValue,
+                            size_t * outValueLength,
+                            JSONTypes_t * outType );
+/* @[declare_json_getvalue] */
+
+/**
+ * @brief Read the integer at a cursor.
+ *
+ * @param[in] cursor  A cursor at the value.
+ * @param[out] outValue  A pointer to receive the integer.
+ *
+ * @return #JSONSuccess if the value is an integer and output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer;
+ * #JSONIllegalDocument if the value is not a number without a fraction or
+ * exponent, or is outside the range of int64_t.
+ */
+/* @[declare_json_getint64] */
+JSONStatus_t JSON_GetInt64( const JSONCursor_t * cursor,
+                            int64_t * outValue );
+/* @[declare_json_getint64] */
+
+/**
+ * @ingroup json_struct_types
+ * @brief The position of one object or array in a document.
+ */
+typedef struct
+{
+    size_t open;  /**< @brief Index of the opening bracket. */
+    size_t close; /**< @brief Index of the closing bracket. */
+} JSONIndexEntry_t;
+
+/**
+ * @brief Same as JSON_Validate(), but also writes the position of every
+ * object and array, for use by JSON_SearchIndexed().
+ *
+ * The index is written in the same pass that validates the document.
+ * Entries are in the order of their opening brackets, one per collection.
+ *
+ * @param[in] buf  The buffer to validate.
+ * @param[in] max  size of the buffer.
+ * @param[out] index  An array to receive the entries; may be NULL if
+ * @p indexCapacity is 0.
+ * @param[in] indexCapacity  The number of entries the array can hold.
+ * @param[out] outIndexCount  A pointer to receive the number of entries
+ * the document requires.
+ *
+ * @return Same as JSON_Validate(), and also
+ * #JSONNullParameter if @p outIndexCount is NULL, or @p index is NULL
+ * while @p indexCapacity is not 0;
+ * #JSONInsufficientMemory if the document is valid but the index is too
+ * small, in which case its contents are not usable.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char buffer[] = "{\"foo\":\"abc\",\"bar\":{\"foo\":\"xyz\"}}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     JSONIndexEntry_t index[ 8 ];
+ *     size_t indexCount;
+ *     const char * value;
+ *     size_t valueLength;
+ *
+ *     result = JSON_ValidateAndIndex( buffer, bufferLength, index, 8, &indexCount );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchIndexed( buffer, bufferLength, index, indexCount,
+ *                                      "bar.foo", 7, &value, &valueLength, NULL );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_validateandindex] */
+JSONStatus_t JSON_ValidateAndIndex( const char * buf,
+                                    size_t max,
+                                    JSONIndexEntry_t * index,
+                                    size_t indexCapacity,
+                                    size_t * outIndexCount );
+/* @[declare_json_validateandindex] */
+
+/**
+ * @brief Same as JSON_SearchConst(), but uses an index written by
+ * JSON_ValidateAndIndex() to skip objects and arrays.
+ *
+ * An object or array that precedes the value sought is passed over by
+ * looking up its closing bracket in the index, rather than by scanning
+ * its contents.  Every other byte before the value is still read and
+ * validated: the keys and scalars passed over at each level of the query,
+ * and the value found.  A search of an index of n entries that passes
+ * over k such bytes and c collections therefore costs O(k + c log n).
+ *
+ * The index saves time only where collections precede the value sought.
+ * For a document whose members are mostly scalars, such as a wide flat
+ * object, a search costs the same as JSON_SearchConst(), and
+ * JSON_ValidateAndIndex() followed by a search costs slightly more than
+ * JSON_Validate() followed by JSON_SearchConst(), as the index is written
+ * but never used.  JSON_SearchTrusted() suits such documents better.
+ *
+ * The index must be the complete index of the same buffer.  A collection
+ * not found in it, or whose entry does not hold a matching bracket,
+ * is scanned instead.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in] max  size of the buffer.
+ * @param[in] index  The index of the buffer.
+ * @param[in] indexCount  The number of entries in the index.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the key.
+ * @param[out] outValue  A pointer to receive the address of the value found.
+ * @param[out] outValueLength  A pointer to receive the length of the value found.
+ * @param[out] outType  An enum indicating the JSON-specific type of the value;
+ * may be NULL.
+ *
+ * @return Same as JSON_SearchConst(), and also
+ * #JSONNullParameter if @p index is NULL while @p indexCount is not 0.
+ * Should the buffer not have been validated, the errors reported are those
+ * of JSON_ObjectFind().
+ */
+/* @[declare_json_searchindexed] */
+JSONStatus_t JSON_SearchIndexed( const char * buf,
+                                 size_t max,
+                                 const JSONIndexEntry_t * index,
+                                 size_t indexCount,
+                                 const char * query,
+                                 size_t queryLength,
+                                 const char ** outValue,
+                                 size_t * outValueLength,
+                                 JSONTypes_t * outType );
+/* @[declare_json_searchindexed] */
+
+/**
+ * @brief Write a hash table of the keys of an object, for use by
+ * JSON_KeyIndexFind().
+ *
+ * Each key is hashed with 32-bit FNV-1a into an open-addressing table
+ * supplied by the caller.  The object is read once, and its values are
+ * skipped and validated.  Where a key is repeated, the first is kept,
+ * matching the result of JSON_ObjectFind().
+ *
+ * A table with at least twice as many slots as the object has keys keeps
+ * lookups short.  The table holds indexes into the buffer, so it remains
+ * usable only while the buffer does not change.
+ *
+ * @param[in] object  A cursor at an object.
+ * @param[out] table  An array to receive the slots.
+ * @param[in] tableCapacity  The number of slots in the array.
+ * @param[out] outKeyCount  A pointer to receive the number of keys
+ * read from the object, including any repeated.
+ *
+ * @return #JSONSuccess if every key was written to the table;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer, or
+ * @p tableCapacity is 0;
+ * #JSONInsufficientMemory if the table is too small, in which case the
+ * object is still read, so that @p outKeyCount holds its number of keys;
+ * #JSONIllegalDocument if the cursor is not at an object, or the object
+ * is not valid JSON;
+ * #JSONMaxDepthExceeded if a value has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the object does.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char buffer[] = "{\"devices\":{\"sn-01\":1,\"sn-02\":2,\"sn-03\":3}}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     JSONCursor_t doc, devices, device;
+ *     JSONKeySlot_t table[ 8 ];
+ *     size_t keyCount;
+ *
+ *     result = JSON_DocOpen( buffer, bufferLength, &doc );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_ObjectFind( &doc, "devices", 7, &devices );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_KeyIndexBuild( &devices, table, 8, &keyCount );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         // Each further lookup reads only the key it compares.
+ *         result = JSON_KeyIndexFind( &devices, table, 8, "sn-02", 5, &device );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_keyindexbuild] */
+JSONStatus_t JSON_KeyIndexBuild( const JSONCursor_t * object,
+                                 JSONKeySlot_t * table,
+                                 size_t tableCapacity,
+                                 size_t * outKeyCount );
+/* @[declare_json_keyindexbuild] */
+
+/**
+ * @brief Find a key of an object using a table written by JSON_KeyIndexBuild().
+ *
+ * Only the keys that share a run of slots with the key sought are
+ * compared, so on average a lookup does not depend on the number of keys
+ * in the object, nor on the size of their values.  As with
+ * JSON_ObjectFind(), keys are compared byte for byte, and the value
+ * found is not read.
+ *
+ * The table must have been written for the same object of the same
+ * buffer.  A slot that does not lie within the buffer is ignored.
+ *
+ * @param[in] object  The cursor the table was written for.
+ * @param[in] table  The slots.
+ * @param[in] tableCapacity  The number of slots.
+ * @param[in] key  The key to search for.
+ * @param[in] keyLength  Length of the key.
+ * @param[out] outValue  A pointer to receive a cursor at the value found.
+ *
+ * @return #JSONSuccess if the key is found and the cursor output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if the cursor is not within its buffer, or
+ * @p tableCapacity is 0;
+ * #JSONNotFound if the table does not hold the key.
+ */
+/* @[declare_json_keyindexfind] */
+JSONStatus_t JSON_KeyIndexFind( const JSONCursor_t * object,
+                                const JSONKeySlot_t * table,
+                                size_t tableCapacity,
+                                const char * key,
+                                size_t keyLength,
+                                JSONCursor_t * outValue );
+/* @[declare_json_keyindexfind] */
+
+/**
+ * @brief Validate an array and write the position of each of its elements,
+ * for use by JSON_ArrayAt().
+ *
+ * The buffer must hold one array, e.g. as output by JSON_SearchConst(),
+ * optionally surrounded by whitespace.  The array is read once, and its
+ * elements are validated.  Afterwards, the number of elements is known,
+ * and an element can be reached without passing over those before it.
+ *
+ * @param[in] buf  The buffer holding the array.
+ * @param[in] max  size of the buffer.
+ * @param[out] offsets  An array to receive the index at which each element
+ * begins; may be NULL if @p offsetsCapacity is 0.
+ * @param[in] offsetsCapacity  The number of indexes the array can hold.
+ * @param[out] outCount  A pointer to receive the number of elements.
+ *
+ * @return #JSONSuccess if the array is valid and every element was written;
+ * #JSONNullParameter if @p buf or @p outCount is NULL, or @p offsets is NULL
+ * while @p offsetsCapacity is not 0;
+ * #JSONBadParameter if max is 0;
+ * #JSONInsufficientMemory if the array is valid but has more elements than
+ * @p offsetsCapacity, in which case the first @p offsetsCapacity are written;
+ * #JSONIllegalDocument if the buffer does not hold one valid array;
+ * #JSONMaxDepthExceeded if an element has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the array does.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char buffer[] = "{\"items\":[10,20,30,40]}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     const char * items, * value;
+ *     size_t itemsLength, valueLength, count;
+ *     size_t offsets[ 16 ];
+ *
+ *     result = JSON_SearchConst( buffer, bufferLength, "items", 5,
+ *                                &items, &itemsLength, NULL );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_ArrayIndexBuild( items, itemsLength, offsets, 16, &count );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         // count == 4; the last element is reached directly.
+ *         result = JSON_ArrayAt( items, itemsLength, offsets, count, count - 1,
+ *                                &value, &valueLength, NULL );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_arrayindexbuild] */
+JSONStatus_t JSON_ArrayIndexBuild( const char * buf,
+                                   size_t max,
+                                   size_t * offsets,
+                                   size_t offsetsCapacity,
+                                   size_t * outCount );
+/* @[declare_json_arrayindexbuild] */
+
+/**
+ * @brief Read an element of an array using the indexes written by
+ * JSON_ArrayIndexBuild().
+ *
+ * Only the element itself is read, so the cost does not depend on its
+ * position in the array.  As with JSON_SearchConst(), a string is output
+ * without its surrounding quotes, and a collection is output as its
+ * JSON text.
+ *
+ * The indexes must have been written for the same buffer.  The element
+ * is validated as it is read, and it must follow '[' or ',' and be
+ * followed by ',' or ']', in each case allowing whitespace; an index that
+ * fails these checks is reported rather than followed.  Text inside a
+ * string can pass them, e.g. the 2 of "[\"1, 2]\"]", so the checks do not
+ * replace the indexes of the same buffer.
+ *
+ * @param[in] buf  The buffer holding the array.
+ * @param[in] max  size of the buffer.
+ * @param[in] offsets  The indexes of the elements.
+ * @param[in] count  The number of indexes.
+ * @param[in] elementIndex  The position of the element to read.
+ * @param[out] outValue  A pointer to receive the address of the element.
+ * @param[out] outValueLength  A pointer to receive the length of the element.
+ * @param[out] outType  An enum indicating the JSON-specific type of the element;
+ * may be NULL.
+ *
+ * @return #JSONSuccess if the element is output;
+ * #JSONNullParameter if any required pointer is NULL;
+ * #JSONBadParameter if max is 0, or the index of the element is not
+ * within the buffer;
+ * #JSONNotFound if @p elementIndex is not less than @p count;
+ * #JSONIllegalDocument if the index does not begin a valid element, or the
+ * element is not delimited as one;
+ * #JSONMaxDepthExceeded if the element has nesting that exceeds JSON_MAX_DEPTH;
+ * #JSONPartial if the buffer ends before the element, or the byte that
+ * follows it.
+ */
+/* @[declare_json_arrayat] */
+JSONStatus_t JSON_ArrayAt( const char * buf,
+                           size_t max,
+                           const size_t * offsets,
+                           size_t count,
+                           size_t elementIndex,
+                           const char ** outValue,
+                           size_t * outValueLength,
+                           JSONTypes_t * outType );
+/* @[declare_json_arrayat] */
+
+/**
+ * @brief Count the elements of an array, or the keys of an object,
+ * without reading them.
+ *
+ * The collection is not validated.  Only the brackets, the commas
+ * between members, and the quotes and backslashes of strings are
+ * examined, in a single pass, so that a count can be had cheaply,
+ * e.g. to size an allocation before the members are extracted.
+ * The buffer should therefore have been validated, e.g. by
+ * JSON_Validate(); the members of an untrusted array are counted
+ * by JSON_ArrayIndexBuild().
+ *
+ * The collection may be followed by further content, which is not read,
+ * so that a pointer into a larger document may be given.
+ *
+ * @param[in] buf  The buffer holding the collection, optionally
+ * preceded by whitespace.
+ * @param[in] max  size of the buffer.
+ * @param[out] outCount  A pointer to receive the number of members.
+ *
+ * @return #JSONSuccess if the collection ends within the buffer and the
+ * count is output;
+ * #JSONNullParameter if any pointer is NULL;
+ * #JSONBadParameter if max is 0;
+ * #JSONIllegalDocument if the buffer does not begin with an object or array;
+ * #JSONPartial if the buffer ends before the collection does.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     char buffer[] = "{\"items\":[{\"id\":1},{\"id\":2},{\"id\":3}]}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     const char * items;
+ *     size_t itemsLength, count;
+ *
+ *     result = JSON_Validate( buffer, bufferLength );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchConst( buffer, bufferLength, "items", 5,
+ *                                    &items, &itemsLength, NULL );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         // count == 3
+ *         result = JSON_Count( items, itemsLength, &count );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_count] */
+JSONStatus_t JSON_Count( const char * buf,
+                         size_t max,
+                         size_t * outCount );
+/* @[declare_json_count] */
+
+/**
+ * @brief Same as JSON_SearchConst(), but for a buffer already known to be
+ * valid, e.g. by JSON_Validate().
+ *
+ * A key is found by searching for its bytes in quotes, rather than by
+ * reading each key and value before it.  Each place the bytes appear is
+ * confirmed by tracking the quotes and brackets before it, so only a key
+ * directly within the object searched is matched.  A key that does not
+ * appear in the document costs a single pass over its bytes.  Array
+ * elements before the one sought, and the value found, are passed over
+ * by their brackets, commas and quotes alone.
+ *
+ * This suits rare keys in large, flat documents.  Nothing is validated, so
+ * the result for a buffer that is not valid JSON is unspecified, except
+ * that no byte past @p max is read.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in] max  size of the buffer.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the key.
+ * @param[out] outValue  A pointer to receive the address of the value found.
+ * @param[out] outValueLength  A pointer to receive the length of the value found.
+ * @param[out] outType  An enum indicating the JSON-specific type of the value;
+ * may be NULL.
+ *
+ * @return Same as JSON_SearchConst() for a valid buffer.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     const char * value;
+ *     size_t valueLength;
+ *
+ *     result = JSON_Validate( buffer, bufferLength );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchTrusted( buffer, bufferLength, "rareKey", 7,
+ *                                      &value, &valueLength, NULL );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_searchtrusted] */
+JSONStatus_t JSON_SearchTrusted( const char * buf,
+                                 size_t max,
+                                 const char * query,
+                                 size_t queryLength,
+                                 const char ** outValue,
+                                 size_t * outValueLength,
+                                 JSONTypes_t * outType );
+/* @[declare_json_searchtrusted] */
+
+/**
+ * @brief Find a value by a query, without reading the value found.
+ *
+ * JSON_SearchConst() reports the length of the value found, and so reads and
+ * validates all of it, which for a large object or array is most of the
+ * work.  This follows the query as JSON_SearchConst() does, validating the
+ * values passed over, but stops at the first byte of the value found.
+ * The value found is therefore reported even if it is not valid.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in] max  size of the buffer.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the query.
+ * @param[out] outValue  A pointer to receive the address of the first byte of
+ * the value found; for a string, its opening quote.
+ * @param[out] outType  An enum indicating the JSON-specific type of the value,
+ * as given by its first byte; may be NULL.
+ *
+ * @return #JSONSuccess if the query is matched;
+ * #JSONNullParameter if any pointer other than @p outType is NULL;
+ * #JSONBadParameter if the buffer or query is empty, or the query is malformed;
+ * #JSONNotFound if a key or index is not present, a value is not of the
+ * type the query expects, or, as for JSON_SearchConst(), the bytes read
+ * before the value are not valid JSON or the buffer ends before it.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     const char * value;
+ *     JSONTypes_t type;
+ *
+ *     result = JSON_SearchStart( buffer, bufferLength, "state.desired", 13,
+ *                                &value, &type );
+ *
+ *     if( ( result == JSONSuccess ) && ( type == JSONObject ) )
+ *     {
+ *         // value points to the '{' of the desired state.
+ *     }
+ * @endcode
+ */
+/* @[declare_json_searchstart] */
+JSONStatus_t JSON_SearchStart( const char * buf,
+                               size_t max,
+                               const char * query,
+                               size_t queryLength,
+                               const char ** outValue,
+                               JSONTypes_t * outType );
+/* @[declare_json_searchstart] */
+
+/**
+ * @brief Check whether a query matches a value, without reading the value.
+ *
+ * Same as JSON_SearchStart(), for when only the presence of the value is
+ * of interest.
+ *
+ * @param[in] buf  The buffer to search.
+ * @param[in] max  size of the buffer.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the query.
+ *
+ * @return Same as JSON_SearchStart().
+ */
+/* @[declare_json_exists] */
+JSONStatus_t JSON_Exists( const char * buf,
+                          size_t max,
+                          const char * query,
+                          size_t queryLength );
+/* @[declare_json_exists] */
+
+#ifdef JSON_ENABLE_STATS
+
+/**
+ * @ingroup json_struct_types
+ * @brief Counters of the work done by the library.
+ *
+ * Available when the library is built with JSON_ENABLE_STATS defined.  When it
+ * is not defined, no counting code is compiled.  Counters are only ever added
+ * to, except for the per-query fields; zero the structure to reset them.
+ *
+ * A value skipped more than once, e.g. when successive searches of the same
+ * document pass over it, is counted each time.  Comparing queryBytesScanned
+ * with queryDocumentLength shows how much of a document a search read.
+ */
+    typedef struct
+    {
+        size_t bytesScanned;        /**< @brief Bytes of values and keys passed over, counting each re-scan. */
+        size_t valuesScanned;       /**< @brief Values passed over by searches and iteration. */
+        size_t collectionsSkipped;  /**< @brief Objects and arrays passed over, including nested ones. */
+        size_t stringsSkipped;      /**< @brief Strings, including keys, passed over. */
+        size_t escapesSkipped;      /**< @brief Escape sequences in strings. */
+        size_t utf8Skipped;         /**< @brief Multi-byte UTF-8 sequences in strings. */
+        size_t queries;             /**< @brief Searches started. */
+        size_t queryBytesScanned;   /**< @brief Bytes passed over since the start of the last search. */
+        size_t queryDocumentLength; /**< @brief Length of the document given to the last search. */
+    } JSONStats_t;
+
+/**
+ * @brief Attach counters to be updated by subsequent calls to the library.
+ *
+ * Available when the library is built with JSON_ENABLE_STATS defined.
+ * The counters are shared by all threads, unless the library is also
+ * built with JSON_STATS_THREAD_LOCAL defined as a thread-local storage
+ * class, e.g. _Thread_local, in which case each thread attaches its own.
+ *
+ * @param[in] stats  The counters to update, or NULL to stop counting.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStats_t stats = { 0 };
+ *     char buffer[] = "{\"foo\":\"abc\",\"bar\":{\"foo\":\"xyz\"}}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     char * value;
+ *     size_t valueLength;
+ *
+ *     JSON_SetStats( &stats );
+ *     ( void ) JSON_Search( buffer, bufferLength, "bar.foo", 7, &value, &valueLength );
+ *     JSON_SetStats( NULL );
+ *
+ *     // stats.queryBytesScanned is the number of bytes read by the search,
+ *     // of stats.queryDocumentLength.
+ * @endcode
+ */
+/* @[declare_json_setstats] */
+    void JSON_SetStats( JSONStats_t * stats );
+/* @[declare_json_setstats] */
+
+#endif /* ifdef JSON_ENABLE_STATS */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -162,8 +162,9 @@ bool arraySearchPostconditions( bool result,
     }
     else
     {
-        validity = ( *outValue == old_outValue ) &&
-                   ( *outValueLength == old_outValueLength );
+        /* The index at which the search stopped. */
+        validity = ( *outValue <= max ) &&
+                   ( *outValueLength == 0U );
     }
 
     return validity;
@@ -1134,6 +1134,51 @@ void test_JSON_Search_Query_Key_Not_Found( void )
     TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
 }
 
+/**
+ * @brief Test the index at which a search stops, as reported by its
+ * return probe.
+ */
+void test_JSON_Search_Stop_Index( void )
+{
+    JSONStatus_t jsonStatus;
+    const char doc[] = "{\"a\":\"xy\",\"b\":[1,{\"c\":2}]}";
+    size_t value, valueLength;
+
+    /* A string ends past its closing quote. */
+    jsonStatus = multiSearch( doc, sizeof( doc ) - 1, "a", 1, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 9, value + valueLength );
+
+    jsonStatus = multiSearch( doc, sizeof( doc ) - 1, "b[1].c", 6, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 23, value + valueLength );
+
+    /* A failed search stops at the bracket that closes the collection
+     * searched, or at the value that it could not search. */
+    jsonStatus = multiSearch( doc, sizeof( doc ) - 1, "x", 1, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 25, value );
+    TEST_ASSERT_EQUAL( 0, valueLength );
+
+    jsonStatus = multiSearch( doc, sizeof( doc ) - 1, "b[5]", 4, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 24, value );
+
+    jsonStatus = multiSearch( doc, sizeof( doc ) - 1, "a.b", 3, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 5, value );
+
+    /* A malformed member stops the search at its start. */
+    jsonStatus = multiSearch( "{\"a\":1,\"b\"}", 11, "b", 1, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 7, value );
+
+    /* A query found bad before the search reads anything. */
+    jsonStatus = multiSearch( doc, sizeof( doc ) - 1, "a.", 2, &value, &valueLength );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, value );
+}
+
 /**
  * @brief Test that JSON_Search can find the right value given an incorrect query
  * key or Illegal JSON string.
@@ -1733,6 +1778,31 @@ void test_JSON_Max_Depth( void )
     free( maxNestedObject );
 }
 
+/**
+ * @brief The values given to matchCollect().
+ */
+typedef struct
+{
+    const char * starts[ 8 ];
+    size_t count;
+    size_t limit;
+} matches_t;
+
+/**
+ * @brief Record each value matched, stopping at the limit.
+ */
+static bool matchCollect( void * context,
+                          const JSONCursor_t * value )
+{
+    matches_t * matches = ( matches_t * ) context;
+
+    TEST_ASSERT_TRUE( matches->count < ( sizeof( matches->starts ) / sizeof( matches->starts[ 0 ] ) ) );
+    matches->starts[ matches->count ] = &value->buf[ value->start ];
+    matches->count++;
+
+    return matches->count < matches->limit;
+}
+
 /**
  * @brief Trip all asserts in internal functions.
  */
@@ -1831,6 +1901,12 @@ void test_JSON_asserts( void )
     catch_assert( nextValue( buf, &start, max, NULL, &valueLength ) );
     catch_assert( nextValue( buf, &start, max, &value, NULL ) );
 
+    catch_assert( nextKey( NULL, &start, max, &key, &keyLength ) );
+    catch_assert( nextKey( buf, NULL, max, &key, &keyLength ) );
+    catch_assert( nextKey( buf, &start, 0, &key, &keyLength ) );
+    catch_assert( nextKey( buf, &start, max, NULL, &keyLength ) );
+    catch_assert( nextKey( buf, &start, max, &key, NULL ) );
+
     catch_assert( nextKeyValuePair( NULL, &start, max, &key, &keyLength, &value, &valueLength ) );
     catch_assert( nextKeyValuePair( buf, NULL, max, &key, &keyLength, &value, &valueLength ) );
     catch_assert( nextKeyValuePair( buf, &start, 0, &key, &keyLength, &value, &valueLength ) );
@@ -1868,6 +1944,211 @@ void test_JSON_asserts( void )
     catch_assert( iterate( buf, max, &start, &next, &key, NULL, &value, &valueLength ) );
     catch_assert( iterate( buf, max, &start, &next, &key, &keyLength, NULL, &valueLength ) );
     catch_assert( iterate( buf, max, &start, &next, &key, &keyLength, &value, NULL ) );
+
+    {
+        writer_t w = { 0 };
+        mergeContext_t ctx = { 0 };
+        mergeFrame_t frame = { 0 };
+        JSONKeySlot_t slot = { 0 };
+
+        catch_assert( writeBytes( NULL, buf, length ) );
+        catch_assert( writeBytes( &w, NULL, length ) );
+
+        catch_assert( hashKey( NULL, 1 ) );
+
+        catch_assert( findKeySlot( NULL, 1, &slot, 1, queryKey, 1, &next ) );
+        catch_assert( findKeySlot( buf, 1, NULL, 1, queryKey, 1, &next ) );
+        catch_assert( findKeySlot( buf, 1, &slot, 0, queryKey, 1, &next ) );
+        catch_assert( findKeySlot( buf, 1, &slot, 1, NULL, 1, &next ) );
+        catch_assert( findKeySlot( buf, 1, &slot, 1, queryKey, 1, NULL ) );
+
+        catch_assert( mergeNextMember( NULL, max, &next, &key, &keyLength, &value, &valueLength ) );
+        catch_assert( mergeNextMember( buf, 0, &next, &key, &keyLength, &value, &valueLength ) );
+        catch_assert( mergeNextMember( buf, max, NULL, &key, &keyLength, &value, &valueLength ) );
+
+        catch_assert( mergeFindKey( NULL, &frame, queryKey, length ) );
+        catch_assert( mergeFindKey( &ctx, NULL, queryKey, length ) );
+        catch_assert( mergeFindKey( &ctx, &frame, NULL, length ) );
+        /* assert: frame->table <= ctx->scratchUsed */
+        frame.table = 1;
+        catch_assert( mergeFindKey( &ctx, &frame, queryKey, length ) );
+        frame.table = 0;
+
+        catch_assert( mergeCountMembers( NULL, start, &next ) );
+        /* assert: patch < ctx->patchLength */
+        catch_assert( mergeCountMembers( &ctx, 0, &next ) );
+
+        catch_assert( mergeWriteTable( NULL, start ) );
+        /* assert: patch < ctx->patchLength */
+        catch_assert( mergeWriteTable( &ctx, 0 ) );
+        /* assert: the patch is an object */
+        ctx.patch = buf;
+        ctx.patchLength = max;
+        catch_assert( mergeWriteTable( &ctx, 0 ) );
+        catch_assert( mergeCountMembers( &ctx, 0, NULL ) );
+
+        catch_assert( mergePush( NULL, false, start, start ) );
+
+        catch_assert( mergeWriteKey( NULL, &frame, buf, start, length ) );
+        catch_assert( mergeWriteKey( &ctx, NULL, buf, start, length ) );
+        catch_assert( mergeWriteKey( &ctx, &frame, NULL, start, length ) );
+        /* assert: key > 0 */
+        catch_assert( mergeWriteKey( &ctx, &frame, buf, 0, length ) );
+
+        catch_assert( mergeValue( NULL, &frame, buf, start, length, 0, start, length ) );
+        catch_assert( mergeValue( &ctx, NULL, buf, start, length, 0, start, length ) );
+
+        catch_assert( mergeTargetMember( NULL, &frame ) );
+        catch_assert( mergeTargetMember( &ctx, NULL ) );
+
+        catch_assert( mergePatchMember( NULL, &frame ) );
+        catch_assert( mergePatchMember( &ctx, NULL ) );
+
+        catch_assert( mergeStep( NULL ) );
+        /* assert: depth > 0 */
+        catch_assert( mergeStep( &ctx ) );
+    }
+
+    {
+        char mbuf[] = "x";
+        size_t mstart = 0, mend = 0;
+
+        catch_assert( minifyToken( NULL, &mstart, 1, &mend ) );
+        catch_assert( minifyToken( mbuf, NULL, 1, &mend ) );
+        catch_assert( minifyToken( mbuf, &mstart, 1, NULL ) );
+        /* assert: end <= start < max */
+        catch_assert( minifyToken( mbuf, &mstart, 0, &mend ) );
+        mend = 1;
+        catch_assert( minifyToken( mbuf, &mstart, 1, &mend ) );
+    }
+
+    catch_assert( findNewline( NULL, 0, 1 ) );
+    catch_assert( validateRecord( NULL, 0, 1, 1 ) );
+    catch_assert( validateRecord( buf, 1, 1, 1 ) );
+    catch_assert( validateRecord( buf, 0, 2, 1 ) );
+
+    catch_assert( skipValue( NULL, &start, 1 ) );
+    catch_assert( skipValue( buf, NULL, 1 ) );
+    catch_assert( skipValue( buf, &start, 0 ) );
+
+    {
+        size_t key;
+        int64_t n;
+        JSONKeySlot_t slot = { 0 };
+
+        catch_assert( cursorOpen( NULL, &start, 1, '[', ']' ) );
+        catch_assert( cursorOpen( buf, NULL, 1, '[', ']' ) );
+        catch_assert( cursorOpen( buf, &start, 1, '[', ']' ) );
+
+        catch_assert( cursorSeparator( NULL, &start, 1, ']' ) );
+        catch_assert( cursorSeparator( buf, NULL, 1, ']' ) );
+        catch_assert( cursorSeparator( buf, &start, 0, ']' ) );
+
+        catch_assert( cursorKey( NULL, &start, 1, &key, &length ) );
+        catch_assert( cursorKey( buf, NULL, 1, &key, &length ) );
+        catch_assert( cursorKey( buf, &start, 0, &key, &length ) );
+        catch_assert( cursorKey( buf, &start, 1, NULL, &length ) );
+        catch_assert( cursorKey( buf, &start, 1, &key, NULL ) );
+
+        catch_assert( cursorFind( NULL, &start, 1, queryKey, 1, NULL ) );
+        catch_assert( cursorFind( buf, NULL, 1, queryKey, 1, NULL ) );
+        catch_assert( cursorFind( buf, &start, 1, queryKey, 1, NULL ) );
+
+        catch_assert( findIndexEntry( NULL, 1, 0 ) );
+
+        catch_assert( skipMember( NULL, &start, 1, NULL ) );
+        catch_assert( skipMember( buf, NULL, 1, NULL ) );
+        catch_assert( skipMember( buf, &start, 1, NULL ) );
+
+        catch_assert( cursorElement( NULL, &start, 1, 0, NULL ) );
+        catch_assert( cursorElement( buf, NULL, 1, 0, NULL ) );
+        catch_assert( cursorElement( buf, &start, 1, 0, NULL ) );
+
+        catch_assert( nextQueryPart( NULL, &start, 2, &length, &queryIndex ) );
+        catch_assert( nextQueryPart( queryKey, NULL, 2, &length, &queryIndex ) );
+        catch_assert( nextQueryPart( queryKey, &start, 1, &length, &queryIndex ) );
+        catch_assert( nextQueryPart( queryKey, &next, 1, NULL, &queryIndex ) );
+        catch_assert( nextQueryPart( queryKey, &next, 1, &length, NULL ) );
+
+        catch_assert( cursorSearch( NULL, &start, 2, queryKey, 1, NULL ) );
+        catch_assert( cursorSearch( buf, NULL, 2, queryKey, 1, NULL ) );
+        catch_assert( cursorSearch( buf, &start, 1, queryKey, 1, NULL ) );
+        catch_assert( cursorSearch( buf, &next, 1, NULL, 1, NULL ) );
+        catch_assert( cursorSearch( buf, &next, 1, queryKey, 0, NULL ) );
+
+        catch_assert( indexCollection( NULL, &start, max, NULL ) );
+        catch_assert( indexCollection( buf, NULL, max, NULL ) );
+        catch_assert( indexCollection( buf, &start, 0, NULL ) );
+
+        catch_assert( indexValue( NULL, &start, 1, NULL ) );
+        catch_assert( indexValue( buf, NULL, 1, NULL ) );
+        catch_assert( indexValue( buf, &start, 0, NULL ) );
+
+        catch_assert( readInt64( NULL, 0, 1, &n ) );
+        catch_assert( readInt64( buf, 1, 1, &n ) );
+        catch_assert( readInt64( buf, 0, 1, NULL ) );
+
+        catch_assert( writeKeyTable( NULL, 0, 1, &slot, 1, &key ) );
+        catch_assert( writeKeyTable( buf, 1, 1, &slot, 1, &key ) );
+        catch_assert( writeKeyTable( buf, 0, 1, &slot, 1, NULL ) );
+
+        catch_assert( writeArrayOffsets( NULL, &next, 1, &key, 1, &length ) );
+        catch_assert( writeArrayOffsets( buf, NULL, 1, &key, 1, &length ) );
+        catch_assert( writeArrayOffsets( buf, &start, 1, &key, 1, &length ) );
+        catch_assert( writeArrayOffsets( buf, &next, 1, NULL, 1, &length ) );
+        catch_assert( writeArrayOffsets( buf, &next, 1, &key, 1, NULL ) );
+
+        catch_assert( skipQuoted( NULL, &next, 1 ) );
+        catch_assert( skipQuoted( buf, NULL, 1 ) );
+        catch_assert( skipQuoted( buf, &start, 1 ) );
+
+        catch_assert( countMembers( NULL, &next, 1, &key ) );
+        catch_assert( countMembers( buf, NULL, 1, &key ) );
+        catch_assert( countMembers( buf, &start, 1, &key ) );
+        catch_assert( countMembers( buf, &next, 1, NULL ) );
+        catch_assert( countMembers( buf, &next, 1, &key ) );
+
+        catch_assert( skipTrusted( NULL, &next, 1 ) );
+        catch_assert( skipTrusted( buf, NULL, 1 ) );
+        catch_assert( skipTrusted( buf, &start, 1 ) );
+
+        catch_assert( findQuotedKey( NULL, 0, 1, queryKey, 1 ) );
+        catch_assert( findQuotedKey( buf, 2, 1, queryKey, 1 ) );
+        catch_assert( findQuotedKey( buf, 0, 1, NULL, 1 ) );
+        catch_assert( findQuotedKey( buf, 0, 1, queryKey, 0 ) );
+
+        catch_assert( findKeyTrusted( NULL, &next, 1, queryKey, 1 ) );
+        catch_assert( findKeyTrusted( buf, NULL, 1, queryKey, 1 ) );
+        catch_assert( findKeyTrusted( buf, &start, 1, queryKey, 1 ) );
+        catch_assert( findKeyTrusted( buf, &next, 1, NULL, 1 ) );
+        catch_assert( findKeyTrusted( buf, &next, 1, queryKey, 0 ) );
+
+        catch_assert( findWildcard( NULL, 1 ) );
+        catch_assert( checkQuery( NULL, 1 ) );
+        catch_assert( eachElement( NULL, 0, 1, queryKey, 1, matchCollect, NULL ) );
+        catch_assert( eachElement( buf, 1, 1, queryKey, 1, matchCollect, NULL ) );
+        catch_assert( eachElement( buf, 0, 1, NULL, 1, matchCollect, NULL ) );
+        catch_assert( eachElement( buf, 0, 1, queryKey, 1, NULL, NULL ) );
+
+        catch_assert( skipElement( NULL, &next, 1 ) );
+        catch_assert( skipElement( buf, NULL, 1 ) );
+        catch_assert( skipElement( buf, &start, 1 ) );
+
+        catch_assert( objectSearchStart( NULL, &next, 1, queryKey, 1 ) );
+        catch_assert( objectSearchStart( buf, NULL, 1, queryKey, 1 ) );
+        catch_assert( objectSearchStart( buf, &start, 1, queryKey, 1 ) );
+        catch_assert( objectSearchStart( buf, &next, 1, NULL, 1 ) );
+
+        catch_assert( arraySearchStart( NULL, &next, 1, 0 ) );
+        catch_assert( arraySearchStart( buf, NULL, 1, 0 ) );
+        catch_assert( arraySearchStart( buf, &start, 1, 0 ) );
+
+        catch_assert( multiSearchStart( NULL, 1, queryKey, 1, &next ) );
+        catch_assert( multiSearchStart( buf, 1, NULL, 1, &next ) );
+        catch_assert( multiSearchStart( buf, 1, queryKey, 1, NULL ) );
+        catch_assert( multiSearchStart( buf, 0, queryKey, 1, &next ) );
+        catch_assert( multiSearchStart( buf, 1, queryKey, 0, &next ) );
+    }
 }
 
 /**
@@ -1882,6 +2163,12 @@ void test_JSON_unreached( void )
     start = max = 1;
     TEST_ASSERT_EQUAL( false, skipUTF8( "abc", &start, max ) );
 
+    /* skipString consumes ASCII characters itself */
+    start = 0;
+    max = 3;
+    TEST_ASSERT_EQUAL( true, skipUTF8( "abc", &start, max ) );
+    TEST_ASSERT_EQUAL( 1, start );
+
     /* return false when buf[ 0 ] != '\\' */
     buf[ 0 ] = 'x';
     start = 0;
@@ -1903,6 +2190,14 @@ void test_JSON_unreached( void )
         TEST_ASSERT_EQUAL( JSONNotFound,
                            iterate( buf, max, &start, &next, &key, &keyLength, &value, &valueLength ) );
     }
+
+    /* ignore key slots outside the buffer, and stop probing a full table */
+    {
+        JSONKeySlot_t table[ 5 ] = { { 2, 1, 5 }, { 9, 2, 5 }, { 6, 2, 5 }, { 2, 2, 9 }, { 2, 2, 5 } };
+        size_t n;
+        TEST_ASSERT_EQUAL( false, findKeySlot( "{\"c\":1}", 7, table, 5, "dd", 2, &n ) );
+        TEST_ASSERT_EQUAL( 5, n );
+    }
 }
 
 /**
@@ -1916,4 +2211,1598 @@ void test_JSON_overflows( void )
 
     start = SIZE_MAX;
     TEST_ASSERT_EQUAL( false, skipOneHexEscape( buf, &start, SIZE_MAX, &u ) );
+
+    /* the length written saturates */
+    {
+        writer_t w = { buf, 1, SIZE_MAX };
+
+        writeBytes( &w, "x", 1 );
+        TEST_ASSERT_EQUAL( SIZE_MAX, w.length );
+    }
+}
+
+/**
+ * @brief Apply a merge patch and check the merged document.
+ */
+static void mergePatchCheck( const char * target,
+                             const char * patch,
+                             const char * expected )
+{
+    JSONStatus_t jsonStatus;
+    JSONKeySlot_t scratch[ 96 ];
+    char out[ 256 ];
+    size_t outLength = 0;
+
+    jsonStatus = JSON_MergePatch( target, strlen( target ),
+                                  patch, strlen( patch ),
+                                  scratch, 96, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( strlen( expected ), outLength );
+    TEST_ASSERT_EQUAL_STRING_LEN( expected, out, outLength );
+}
+
+/**
+ * @brief Test JSON_MergePatch with the examples from RFC 7396, Appendix A.
+ */
+void test_JSON_MergePatch_RFC7396( void )
+{
+    mergePatchCheck( "{\"a\":\"b\"}", "{\"a\":\"c\"}", "{\"a\":\"c\"}" );
+    mergePatchCheck( "{\"a\":\"b\"}", "{\"b\":\"c\"}", "{\"a\":\"b\",\"b\":\"c\"}" );
+    mergePatchCheck( "{\"a\":\"b\"}", "{\"a\":null}", "{}" );
+    mergePatchCheck( "{\"a\":\"b\",\"b\":\"c\"}", "{\"a\":null}", "{\"b\":\"c\"}" );
+    mergePatchCheck( "{\"a\":[\"b\"]}", "{\"a\":\"c\"}", "{\"a\":\"c\"}" );
+    mergePatchCheck( "{\"a\":\"c\"}", "{\"a\":[\"b\"]}", "{\"a\":[\"b\"]}" );
+    mergePatchCheck( "{\"a\":{\"b\":\"c\"}}", "{\"a\":{\"b\":\"d\",\"c\":null}}", "{\"a\":{\"b\":\"d\"}}" );
+    mergePatchCheck( "{\"a\":[{\"b\":\"c\"}]}", "{\"a\":[1]}", "{\"a\":[1]}" );
+    mergePatchCheck( "[\"a\",\"b\"]", "[\"c\",\"d\"]", "[\"c\",\"d\"]" );
+    mergePatchCheck( "{\"a\":\"b\"}", "[\"c\"]", "[\"c\"]" );
+    mergePatchCheck( "{\"a\":\"foo\"}", "null", "null" );
+    mergePatchCheck( "{\"a\":\"foo\"}", "\"bar\"", "\"bar\"" );
+    mergePatchCheck( "{\"e\":null}", "{\"a\":1}", "{\"e\":null,\"a\":1}" );
+    mergePatchCheck( "[1,2]", "{\"a\":\"b\",\"c\":null}", "{\"a\":\"b\"}" );
+    mergePatchCheck( "{}", "{\"a\":{\"bb\":{\"ccc\":null}}}", "{\"a\":{\"bb\":{}}}" );
+}
+
+/**
+ * @brief Test JSON_MergePatch with whitespace, nesting and wide objects.
+ */
+void test_JSON_MergePatch_Legal_Documents( void )
+{
+    /* Values are copied as is, while the output is otherwise compact. */
+    mergePatchCheck( " { \"a\" : [ 1, 2 ] , \"b\" : { \"c\" : 3 } } ",
+                     " { \"b\" : { \"d\" : { \"e\" : null, \"f\" : [ 4 ] } } } ",
+                     "{\"a\":[ 1, 2 ],\"b\":{\"c\":3,\"d\":{\"f\":[ 4 ]}}}" );
+
+    /* Keys of differing lengths do not match. */
+    mergePatchCheck( "{\"ab\":1,\"a\":2}", "{\"abc\":3,\"a\":4}", "{\"ab\":1,\"a\":4,\"abc\":3}" );
+
+    /* A target without a value is merged as an empty object. */
+    mergePatchCheck( WHITE_SPACE, "{\"a\":1,\"b\":null}", "{\"a\":1}" );
+
+    /* An object replaces a scalar, dropping nulls from the patch. */
+    mergePatchCheck( "{\"a\":1,\"b\":2}",
+                     "{\"a\":{\"x\":null,\"y\":true},\"b\":null}",
+                     "{\"a\":{\"y\":true}}" );
+
+    /* Wide objects are merged through the key table, in the order of the target. */
+    mergePatchCheck( "{\"k\":0,\"z\":1}",
+                     "{\"0\":0,\"1\":1,\"2\":2,\"3\":3,\"4\":4,\"5\":5,\"6\":6,\"7\":7,"
+                     "\"8\":8,\"9\":9,\"a\":0,\"b\":1,\"c\":2,\"d\":3,\"e\":4,\"f\":5,"
+                     "\"g\":6,\"h\":7,\"i\":8,\"j\":9,\"l\":0,\"m\":1,\"n\":2,\"o\":3,"
+                     "\"p\":4,\"q\":5,\"r\":6,\"s\":7,\"t\":8,\"u\":9,\"v\":0,\"w\":1,"
+                     "\"z\":{\"y\":1},\"x\":null,\"y\":2}",
+                     "{\"k\":0,\"z\":{\"y\":1},\"0\":0,\"1\":1,\"2\":2,\"3\":3,\"4\":4,\"5\":5,"
+                     "\"6\":6,\"7\":7,\"8\":8,\"9\":9,\"a\":0,\"b\":1,\"c\":2,\"d\":3,\"e\":4,"
+                     "\"f\":5,\"g\":6,\"h\":7,\"i\":8,\"j\":9,\"l\":0,\"m\":1,\"n\":2,\"o\":3,"
+                     "\"p\":4,\"q\":5,\"r\":6,\"s\":7,\"t\":8,\"u\":9,\"v\":0,\"w\":1,\"y\":2}" );
+
+    /* Without a target object, members are added in the order of the patch. */
+    mergePatchCheck( "[]",
+                     "{\"0\":0,\"1\":1,\"2\":2,\"3\":3,\"4\":4,\"5\":5,\"6\":6,\"7\":7,"
+                     "\"8\":8,\"9\":9,\"a\":0,\"b\":1,\"c\":2,\"d\":3,\"e\":4,\"f\":5,"
+                     "\"g\":6,\"h\":7,\"i\":8,\"j\":9,\"l\":0,\"m\":1,\"n\":2,\"o\":3,"
+                     "\"p\":4,\"q\":5,\"r\":6,\"s\":7,\"t\":8,\"u\":9,\"v\":0,\"w\":1,"
+                     "\"x\":null,\"y\":2}",
+                     "{\"0\":0,\"1\":1,\"2\":2,\"3\":3,\"4\":4,\"5\":5,\"6\":6,\"7\":7,"
+                     "\"8\":8,\"9\":9,\"a\":0,\"b\":1,\"c\":2,\"d\":3,\"e\":4,\"f\":5,"
+                     "\"g\":6,\"h\":7,\"i\":8,\"j\":9,\"l\":0,\"m\":1,\"n\":2,\"o\":3,"
+                     "\"p\":4,\"q\":5,\"r\":6,\"s\":7,\"t\":8,\"u\":9,\"v\":0,\"w\":1,\"y\":2}" );
+
+    /* The last of a repeated patch key is applied, and written once. */
+    mergePatchCheck( "{\"a\":1,\"b\":2}", "{\"a\":3,\"c\":4,\"a\":null,\"c\":5}", "{\"b\":2,\"c\":5}" );
+    mergePatchCheck( "{\"a\":1}", "{\"a\":null,\"a\":{\"b\":1,\"b\":2}}", "{\"a\":{\"b\":2}}" );
+
+    /* A repeated target key is merged with the patch only once. */
+    mergePatchCheck( "{\"a\":1,\"b\":2,\"a\":3}", "{\"a\":4}", "{\"a\":4,\"b\":2}" );
+
+    /* Empty objects have no key table. */
+    mergePatchCheck( "{\"a\":{\"b\":1}}", "{\"a\":{ }}", "{\"a\":{\"b\":1}}" );
+}
+
+/**
+ * @brief Test JSON_MergePatch with invalid parameters and insufficient output.
+ */
+void test_JSON_MergePatch_Invalid_Params( void )
+{
+    JSONStatus_t jsonStatus;
+    char target[] = "{\"a\":\"b\"}", patch[] = "{\"c\":\"d\"}";
+    char deep[] = "{\"c\":{\"d\":{\"e\":1}}}";
+    JSONKeySlot_t scratch[ JSON_MAX_DEPTH * 2 ];
+    char out[ 16 ];
+    size_t outLength = 0;
+    char * nested;
+
+    jsonStatus = JSON_MergePatch( NULL, 1, patch, 1, scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 1, NULL, 1, scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 1, patch, 1, NULL, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 1, patch, 1, scratch, 2, NULL, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 1, patch, 1, scratch, 2, out, sizeof( out ), NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 0, patch, 1, scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 1, patch, 0, scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_MergePatch( target, 1, patch, 1, scratch, 2, out, 0, &outLength );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    /* The patch must contain a value. */
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, WHITE_SPACE, WHITE_SPACE_LENGTH,
+                                  scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* An object of the patch must end. */
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, patch, sizeof( patch ) - 2,
+                                  scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* The size required is output when the buffer is too small. */
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, patch, sizeof( patch ) - 1,
+                                  scratch, 2, out, 4, &outLength );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( sizeof( "{\"a\":\"b\",\"c\":\"d\"}" ) - 1, outLength );
+
+    /* Without enough scratch slots, no size is output. */
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, patch, sizeof( patch ) - 1,
+                                  scratch, 1, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, outLength );
+
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, deep, sizeof( deep ) - 1,
+                                  scratch, 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+
+    /* A patch without members needs no scratch slots. */
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, "{}", 2,
+                                  NULL, 0, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( target, out, outLength );
+
+    /* Each member of an object of the patch must be well formed. */
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, "{\"c\":1,,\"d\":2}", 15,
+                                  scratch, 6, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    nested = allocateMaxDepthObject();
+    jsonStatus = JSON_MergePatch( target, sizeof( target ) - 1, nested, strlen( nested ),
+                                  scratch, JSON_MAX_DEPTH * 2, out, sizeof( out ), &outLength );
+    TEST_ASSERT_EQUAL( JSONMaxDepthExceeded, jsonStatus );
+    free( nested );
+
+    /* A patch member missing from the key table is not merged. */
+    {
+        mergeContext_t ctx = { 0 };
+        mergeFrame_t frame = { 0 };
+
+        ctx.patch = patch;
+        ctx.patchLength = sizeof( patch ) - 1;
+        ctx.out.buf = out;
+        ctx.out.max = sizeof( out );
+        frame.patchNext = 1;
+
+        jsonStatus = mergePatchMember( &ctx, &frame );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 0, ctx.out.length );
+    }
+}
+
+/**
+ * @brief Test that JSON_Minify removes whitespace outside of strings only.
+ */
+void test_JSON_Minify( void )
+{
+    JSONStatus_t jsonStatus;
+    char pretty[] = "\r\n{\n\t\"foo\" : \"a b\\\" c\",\n\t\"bar\" : [ 1 , -2.5e3 , true ]\n}  ";
+    char minified[] = "{\"foo\":\"a b\\\" c\",\"bar\":[1,-2.5e3,true]}";
+    char malformed[] = "{ \"foo\" : \"\x15\" }";
+    char blank[] = WHITE_SPACE;
+    char joined[] = "\t[ 1 \t 2 , tr ue , - 1 , \"a\" \"b\" , 3 : 4 \"c\" , 5 [ ] , 6 { } ] ";
+    char spaced[] = "[1 2,tr ue,- 1,\"a\"\"b\",3:4\"c\",5[],6{}]";
+    char nested[] = "{ \"a\" : { } , \"b\" : [ [ ] , { } ] , \"c\" : 1 }";
+    size_t length = 0;
+
+    jsonStatus = JSON_Minify( nested, sizeof( nested ) - 1, &length );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "{\"a\":{},\"b\":[[],{}],\"c\":1}", nested, length );
+
+    jsonStatus = JSON_Minify( pretty, sizeof( pretty ) - 1, &length );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( sizeof( minified ) - 1, length );
+    TEST_ASSERT_EQUAL_STRING_LEN( minified, pretty, length );
+    TEST_ASSERT_EQUAL( JSONSuccess, JSON_Validate( pretty, length ) );
+
+    jsonStatus = JSON_Minify( joined, sizeof( joined ) - 1, &length );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( sizeof( spaced ) - 1, length );
+    TEST_ASSERT_EQUAL_STRING_LEN( spaced, joined, length );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, JSON_Validate( joined, length ) );
+
+    jsonStatus = JSON_Minify( blank, sizeof( blank ) - 1, &length );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, length );
+
+    jsonStatus = JSON_Minify( malformed, sizeof( malformed ) - 1, &length );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    jsonStatus = JSON_Minify( NULL, 1, &length );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_Minify( pretty, 1, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_Minify( pretty, 0, &length );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test splitting a stream of newline-delimited documents.
+ */
+void test_JSON_NextRecord( void )
+{
+    JSONStatus_t jsonStatus, recordStatus;
+    char buf[] = "{\"a\":1}\r\n"
+                 "\n"
+                 "  \t\n"
+                 " [1,2]\n"
+                 "{\"b\":[\n"
+                 "{\"a\":1}}\n"
+                 "\"str\"\n"
+                 "{\"b\":[";
+    size_t max = sizeof( buf ) - 1;
+    size_t offset = 0, start, length;
+    size_t recordCount = 0, validCount = 0;
+
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, recordStatus );
+    TEST_ASSERT_EQUAL( 0, start );
+    TEST_ASSERT_EQUAL( 8, length );
+    TEST_ASSERT_EQUAL( 9, offset );
+
+    /* Blank lines are skipped and leading whitespace is trimmed. */
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, recordStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "[1,2]", &buf[ start ], length );
+
+    /* An incomplete record ended by a newline is illegal. */
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, recordStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "{\"b\":[", &buf[ start ], length );
+
+    /* The stream resumes after a malformed record. */
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, recordStatus );
+
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, recordStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "\"str\"", &buf[ start ], length );
+
+    /* An unterminated final record may be completed by more data. */
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONPartial, recordStatus );
+    TEST_ASSERT_EQUAL( max, start + length );
+    TEST_ASSERT_EQUAL( max, offset );
+
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* Count the records of the whole stream. */
+    offset = 0;
+
+    while( JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus ) == JSONSuccess )
+    {
+        recordCount++;
+
+        if( recordStatus == JSONSuccess )
+        {
+            validCount++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL( 6, recordCount );
+    TEST_ASSERT_EQUAL( 3, validCount );
+
+    /* A stream of blank lines has no records. */
+    offset = 0;
+    jsonStatus = JSON_NextRecord( " \n\n ", 4, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 4, offset );
+
+    /* A stream may begin with empty lines. */
+    offset = 0;
+    jsonStatus = JSON_NextRecord( "\n\n[]", 4, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, start );
+    TEST_ASSERT_EQUAL( 2, length );
+
+    /* A stream may hold nothing but empty lines. */
+    offset = 0;
+    jsonStatus = JSON_NextRecord( "\n\n", 2, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, offset );
+
+    offset = 0;
+    jsonStatus = JSON_NextRecord( buf, 0, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    offset = max + 1;
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_NextRecord( NULL, max, &offset, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_NextRecord( buf, max, NULL, &start, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_NextRecord( buf, max, &offset, NULL, &length, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, NULL, &recordStatus );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_NextRecord( buf, max, &offset, &start, &length, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+}
+
+/**
+ * @brief Test validating the first of several concatenated documents.
+ */
+void test_JSON_ValidatePrefix( void )
+{
+    JSONStatus_t jsonStatus;
+    char buf[] = " {\"a\":[1,{}]}[true] \"str\"{\"b\":[";
+    size_t max = sizeof( buf ) - 1;
+    size_t start = 0, consumed = 0;
+
+    jsonStatus = JSON_ValidatePrefix( buf, max, &consumed );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 13, consumed );
+    start += consumed;
+
+    jsonStatus = JSON_ValidatePrefix( &buf[ start ], max - start, &consumed );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "[true]", &buf[ start ], consumed );
+    start += consumed;
+
+    /* Leading whitespace is counted. */
+    jsonStatus = JSON_ValidatePrefix( &buf[ start ], max - start, &consumed );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( " \"str\"", &buf[ start ], consumed );
+    start += consumed;
+
+    /* The last document is incomplete. */
+    consumed = 0;
+    jsonStatus = JSON_ValidatePrefix( &buf[ start ], max - start, &consumed );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, consumed );
+
+    jsonStatus = JSON_ValidatePrefix( "  ", 2, &consumed );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+
+    jsonStatus = JSON_ValidatePrefix( "{]{}", 4, &consumed );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* JSON_Validate rejects the same buffer. */
+    jsonStatus = JSON_Validate( "{}{}", 4 );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    jsonStatus = JSON_ValidatePrefix( NULL, max, &consumed );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_ValidatePrefix( buf, max, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_ValidatePrefix( buf, 0, &consumed );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test the counters enabled by JSON_ENABLE_STATS.
+ */
+void test_JSON_Stats( void )
+{
+#ifdef JSON_ENABLE_STATS
+    JSONStatus_t jsonStatus;
+    JSONStats_t stats = { 0 };
+    char buf[] = "{\"a\":\"\\u00e9\xC3\xA9\",\"b\":[1,{\"c\":2}],\"d\":3}";
+    size_t max = sizeof( buf ) - 1;
+    const char * value;
+    size_t valueLength;
+
+    JSON_SetStats( &stats );
+
+    jsonStatus = JSON_Validate( buf, max );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( max, stats.bytesScanned );
+    TEST_ASSERT_EQUAL( 3, stats.collectionsSkipped );
+    TEST_ASSERT_EQUAL( 5, stats.stringsSkipped );
+    TEST_ASSERT_EQUAL( 1, stats.escapesSkipped );
+    TEST_ASSERT_EQUAL( 1, stats.utf8Skipped );
+    TEST_ASSERT_EQUAL( 0, stats.valuesScanned );
+    TEST_ASSERT_EQUAL( 0, stats.queries );
+
+    /* The search passes over the keys and values before "d". */
+    jsonStatus = JSON_SearchConst( buf, max, "d", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 1, stats.queries );
+    TEST_ASSERT_EQUAL( max, stats.queryDocumentLength );
+    TEST_ASSERT_EQUAL( 3, stats.valuesScanned );
+    TEST_ASSERT_EQUAL( 31, stats.queryBytesScanned );
+
+    /* The array holding "c" is scanned once to find "b", and again to find "c". */
+    jsonStatus = JSON_SearchConst( buf, max, "b[1].c", 6, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, stats.queries );
+    TEST_ASSERT_EQUAL( 8, stats.valuesScanned );
+    TEST_ASSERT_EQUAL( 39, stats.queryBytesScanned );
+
+    /* Reading on demand passes over the key "a", its value and the key "b" only. */
+    {
+        JSONCursor_t doc, value, element = { 0 };
+
+        stats.bytesScanned = 0;
+        stats.valuesScanned = 0;
+        jsonStatus = JSON_DocOpen( buf, max, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_ObjectFind( &doc, "b", 1, &value );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 1, stats.valuesScanned );
+        TEST_ASSERT_EQUAL( 16, stats.bytesScanned );
+
+        /* Skipping the first element of "b" passes over it. */
+        jsonStatus = JSON_ArrayNext( &value, &element );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_ArrayNext( &value, &element );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 2, stats.valuesScanned );
+        TEST_ASSERT_EQUAL( 17, stats.bytesScanned );
+    }
+
+    /* With an index, the array "b" is skipped without being scanned. */
+    {
+        JSONIndexEntry_t index[ 3 ];
+        size_t indexCount;
+
+        jsonStatus = JSON_ValidateAndIndex( buf, max, index, 3, &indexCount );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_SearchIndexed( buf, max, index, indexCount, "d", 1, &value, &valueLength, NULL );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 3, stats.queries );
+        TEST_ASSERT_EQUAL( 20, stats.queryBytesScanned );
+        jsonStatus = JSON_SearchIndexed( buf, max, index, indexCount, "b[1]", 4, &value, &valueLength, NULL );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    }
+
+    /* A key table is written by passing over the whole object once;
+     * lookups then pass over nothing. */
+    {
+        JSONCursor_t doc, value;
+        JSONKeySlot_t table[ 6 ];
+        size_t keyCount;
+
+        stats.bytesScanned = 0;
+        stats.valuesScanned = 0;
+        jsonStatus = JSON_DocOpen( buf, max, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_KeyIndexBuild( &doc, table, 6, &keyCount );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 3, stats.valuesScanned );
+        TEST_ASSERT_EQUAL( 31, stats.bytesScanned );
+        jsonStatus = JSON_KeyIndexFind( &doc, table, 6, "d", 1, &value );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 3, stats.valuesScanned );
+        TEST_ASSERT_EQUAL( 31, stats.bytesScanned );
+    }
+
+    /* Indexing the array "b" passes over each element once. */
+    {
+        size_t offsets[ 2 ], count;
+
+        jsonStatus = JSON_SearchConst( buf, max, "b", 1, &value, &valueLength, NULL );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        stats.valuesScanned = 0;
+        jsonStatus = JSON_ArrayIndexBuild( value, valueLength, offsets, 2, &count );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 2, stats.valuesScanned );
+
+        /* Counting passes over the bytes of the array, but no values. */
+        stats.bytesScanned = 0;
+        jsonStatus = JSON_Count( value, valueLength, &count );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 2, count );
+        TEST_ASSERT_EQUAL( valueLength, stats.bytesScanned );
+        TEST_ASSERT_EQUAL( 2, stats.valuesScanned );
+    }
+
+    /* A trusted search passes over the bytes of the object up to the key,
+     * and the value. */
+    jsonStatus = JSON_SearchTrusted( buf, max, "d", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 6, stats.queries );
+    TEST_ASSERT_EQUAL( 32 + 1, stats.queryBytesScanned );
+
+    /* Finding the start of "b" passes over the key "a", its value and the
+     * key "b", but not the array itself. */
+    jsonStatus = JSON_SearchStart( buf, max, "b", 1, &value, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 7, stats.queries );
+    TEST_ASSERT_EQUAL( 16, stats.queryBytesScanned );
+
+    /* A search from "b" passes over its first element and the key "c" only. */
+    {
+        JSONCursor_t doc, b, c;
+
+        jsonStatus = JSON_DocOpen( buf, max, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_SearchFrom( &doc, "b", 1, &b );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 16, stats.queryBytesScanned );
+        jsonStatus = JSON_SearchFrom( &b, "[1].c", 5, &c );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 9, stats.queries );
+        TEST_ASSERT_EQUAL( max - b.start, stats.queryDocumentLength );
+        TEST_ASSERT_EQUAL( 1 + 3, stats.queryBytesScanned );
+    }
+
+    /* A wildcard search passes over each element once. */
+    {
+        JSONCursor_t doc;
+        matches_t matches = { { 0 }, 0, SIZE_MAX };
+
+        jsonStatus = JSON_DocOpen( buf, max, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        stats.valuesScanned = 0;
+        jsonStatus = JSON_SearchEach( &doc, "b[*]", 4, matchCollect, &matches );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 2, matches.count );
+        TEST_ASSERT_EQUAL( 10, stats.queries );
+        TEST_ASSERT_EQUAL( 1 + 2, stats.valuesScanned );
+        TEST_ASSERT_EQUAL( 16 + 1 + 7, stats.queryBytesScanned );
+    }
+
+    JSON_SetStats( NULL );
+
+    jsonStatus = JSON_Validate( buf, max );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 10, stats.queries );
+#else
+    TEST_IGNORE_MESSAGE( "The counters require JSON_ENABLE_STATS." );
+#endif
+}
+
+/**
+ * @brief Test that runs of plain string characters end correctly
+ * whether or not a stop byte is found near the end of the buffer.
+ */
+void test_JSON_String_Runs( void )
+{
+    size_t i;
+    struct
+    {
+        const char * doc;
+        JSONStatus_t expected;
+    }
+    cases[] =
+    {
+        { "[\"abcdef\"]",                          JSONSuccess         },
+        { "{\"key\":\"abc\\tdef\"}",               JSONSuccess         },
+        { "[\"abc\xC3\xA9" "def\"]",               JSONSuccess         },
+        { "[\"abc\x01" "def\"]",                   JSONIllegalDocument },
+        { "[\"abcdef\"]\n",                        JSONSuccess         },
+        { "[\"abcdefghijklmnop\",12345678901234]", JSONSuccess         },
+        { "[\"abcdef\",\"ghi",                     JSONIllegalDocument },
+        { "[1,\"abcdefghijklmnop",                 JSONIllegalDocument },
+    };
+
+    for( i = 0; i < ( sizeof( cases ) / sizeof( cases[ 0 ] ) ); i++ )
+    {
+        TEST_ASSERT_EQUAL( cases[ i ].expected,
+                           JSON_Validate( cases[ i ].doc, strlen( cases[ i ].doc ) ) );
+    }
+}
+
+/**
+ * @brief Test reading a document on demand with a cursor.
+ */
+void test_JSON_Cursor( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONCursor_t doc, value, element = { 0 };
+    char buf[] = " {\"a\" : [1, {\"b\":2}, -3] , \"c\":\"xyz\", \"d\":1} ";
+    size_t max = sizeof( buf ) - 1;
+    const char * outValue;
+    size_t outValueLength;
+    JSONTypes_t outType;
+    int64_t n;
+
+    jsonStatus = JSON_DocOpen( buf, max, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 1, doc.start );
+
+    jsonStatus = JSON_ObjectFind( &doc, "c", 1, &value );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_GetValue( &value, &outValue, &outValueLength, &outType );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONString, outType );
+    TEST_ASSERT_EQUAL( 3, outValueLength );
+    TEST_ASSERT_EQUAL_STRING_LEN( "xyz", outValue, outValueLength );
+
+    jsonStatus = JSON_ObjectFind( &doc, "x", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_ObjectFind( &doc, "aa", 2, &value );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* Step through the array, reading only the integers. */
+    jsonStatus = JSON_ObjectFind( &doc, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_ArrayNext( &value, &element );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_GetInt64( &element, &n );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 1, n );
+    jsonStatus = JSON_ArrayNext( &value, &element );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_GetInt64( &element, &n );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_GetValue( &element, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "{\"b\":2}", outValue, outValueLength );
+    jsonStatus = JSON_ArrayNext( &value, &element );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_GetInt64( &element, &n );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( -3, n );
+    jsonStatus = JSON_ArrayNext( &value, &element );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    element.start = 0;
+    jsonStatus = JSON_ArrayNext( &doc, &element );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* Only the bytes read are validated. */
+    {
+        char lazy[] = "{\"a\":1,\"b\":[}";
+        char empty[] = "[ ]";
+        char * partial[] = { "{", "{\"a\"", "{\"a\":", "{\"a\":1", "{\"a\":1," };
+        char * illegal[] = { "{1:2}", "{\"a\"1}", "{\"a\":1 2}", "{\"a\":1,}", "{\"a\":[}" };
+        size_t i;
+
+        jsonStatus = JSON_DocOpen( lazy, sizeof( lazy ) - 1, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_ObjectFind( &doc, "a", 1, &value );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_ObjectFind( &doc, "b", 1, &value );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_GetValue( &value, &outValue, &outValueLength, NULL );
+        TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+        jsonStatus = JSON_ObjectFind( &doc, "c", 1, &value );
+        TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+        jsonStatus = JSON_DocOpen( empty, sizeof( empty ) - 1, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        element.start = 0;
+        jsonStatus = JSON_ArrayNext( &doc, &element );
+        TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+        jsonStatus = JSON_DocOpen( "[1,]", 4, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        element.start = 0;
+        jsonStatus = JSON_ArrayNext( &doc, &element );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_ArrayNext( &doc, &element );
+        TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+        jsonStatus = JSON_DocOpen( "[{,]", 4, &doc );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        element.start = 0;
+        jsonStatus = JSON_ArrayNext( &doc, &element );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_ArrayNext( &doc, &element );
+        TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+        for( i = 0; i < ( sizeof( partial ) / sizeof( partial[ 0 ] ) ); i++ )
+        {
+            doc.buf = partial[ i ];
+            doc.max = strlen( partial[ i ] );
+            doc.start = 0;
+            jsonStatus = JSON_ObjectFind( &doc, "b", 1, &value );
+            TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+        }
+
+        for( i = 0; i < ( sizeof( illegal ) / sizeof( illegal[ 0 ] ) ); i++ )
+        {
+            doc.buf = illegal[ i ];
+            doc.max = strlen( illegal[ i ] );
+            doc.start = 0;
+            jsonStatus = JSON_ObjectFind( &doc, "b", 1, &value );
+            TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+        }
+    }
+
+    /* Integers at and beyond the limits of int64_t. */
+    {
+        char * legal[] = { "9223372036854775807", "-9223372036854775808", "-0", "0]", "0}",
+                           "7 ", "7\t", "7\n", "7\r", "7," };
+        int64_t expected[] = { INT64_MAX, INT64_MIN, 0, 0, 0, 7, 7, 7, 7, 7 };
+        char * illegal[] = { "9223372036854775808", "-9223372036854775809", "1.5", "1e3", "012", "x", "7x" };
+        size_t i;
+
+        for( i = 0; i < ( sizeof( legal ) / sizeof( legal[ 0 ] ) ); i++ )
+        {
+            jsonStatus = JSON_DocOpen( legal[ i ], strlen( legal[ i ] ), &doc );
+            TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+            jsonStatus = JSON_GetInt64( &doc, &n );
+            TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+            TEST_ASSERT_EQUAL( expected[ i ], n );
+        }
+
+        for( i = 0; i < ( sizeof( illegal ) / sizeof( illegal[ 0 ] ) ); i++ )
+        {
+            jsonStatus = JSON_DocOpen( illegal[ i ], strlen( illegal[ i ] ), &doc );
+            TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+            jsonStatus = JSON_GetInt64( &doc, &n );
+            TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+        }
+    }
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_DocOpen( NULL, max, &doc );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_DocOpen( buf, max, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_DocOpen( buf, 0, &doc );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_DocOpen( "  ", 2, &doc );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+
+    jsonStatus = JSON_DocOpen( buf, max, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_ObjectFind( NULL, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ObjectFind( &doc, NULL, 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ObjectFind( &doc, "a", 1, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayNext( NULL, &element );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayNext( &doc, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    element.start = max;
+    jsonStatus = JSON_ArrayNext( &doc, &element );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_GetValue( NULL, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_GetValue( &doc, NULL, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_GetValue( &doc, &outValue, NULL, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_GetInt64( &doc, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    doc.buf = NULL;
+    jsonStatus = JSON_GetInt64( &doc, &n );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    doc.buf = buf;
+    doc.start = max;
+    jsonStatus = JSON_GetInt64( &doc, &n );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test validating a document while writing its index, and
+ * searching it with the index.
+ */
+void test_JSON_ValidateAndIndex( void )
+{
+    JSONStatus_t jsonStatus, expectedStatus;
+    char buf[] = "{\"a\":[1,{\"b\":[]},[2]],\"c\":{\"d\":\"xyz\"},\"e\":3}";
+    size_t max = sizeof( buf ) - 1;
+    JSONIndexEntry_t index[ 6 ];
+    size_t i, indexCount;
+    const char * value, * expectedValue;
+    size_t valueLength, expectedValueLength;
+    JSONTypes_t type, expectedType;
+    const char * queries[] =
+    {
+        "a",   "a[0]", "a[1]", "a[1].b", "a[2][0]", "a[3]", "c.d", "e", "x", "e.x", "a.b", "c[0]",
+        "a[",  "a[1", "a[1x", "a.",     ".a",      "[x]"
+    };
+
+    jsonStatus = JSON_ValidateAndIndex( buf, max, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 6, indexCount );
+    TEST_ASSERT_EQUAL( 0, index[ 0 ].open );
+    TEST_ASSERT_EQUAL( max - 1, index[ 0 ].close );
+    TEST_ASSERT_EQUAL( 5, index[ 1 ].open );
+    TEST_ASSERT_EQUAL( 20, index[ 1 ].close );
+    TEST_ASSERT_EQUAL( 13, index[ 3 ].open );
+    TEST_ASSERT_EQUAL( 14, index[ 3 ].close );
+
+    /* The indexed search agrees with JSON_SearchConst(). */
+    for( i = 0; i < ( sizeof( queries ) / sizeof( queries[ 0 ] ) ); i++ )
+    {
+        expectedStatus = JSON_SearchConst( buf, max, queries[ i ], strlen( queries[ i ] ),
+                                           &expectedValue, &expectedValueLength, &expectedType );
+        jsonStatus = JSON_SearchIndexed( buf, max, index, indexCount, queries[ i ], strlen( queries[ i ] ),
+                                         &value, &valueLength, &type );
+        TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+
+        if( jsonStatus == JSONSuccess )
+        {
+            TEST_ASSERT_EQUAL_PTR( expectedValue, value );
+            TEST_ASSERT_EQUAL( expectedValueLength, valueLength );
+            TEST_ASSERT_EQUAL( expectedType, type );
+        }
+    }
+
+    /* Without an index, or with unusable entries, collections are scanned. */
+    jsonStatus = JSON_SearchIndexed( buf, max, NULL, 0, "e", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( '3', value[ 0 ] );
+    index[ 1 ].close = max;
+    index[ 2 ].close = index[ 2 ].open;
+    index[ 4 ].close = index[ 4 ].open + 1;
+    index[ 5 ].close = index[ 5 ].open + 1;
+    jsonStatus = JSON_SearchIndexed( buf, max, index, indexCount, "e", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( '3', value[ 0 ] );
+    jsonStatus = JSON_SearchIndexed( buf, max, index, indexCount, "a[3]", 4, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, max, index, indexCount, "c", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 11, valueLength );
+
+    /* An index that is too small is counted, but not usable. */
+    jsonStatus = JSON_ValidateAndIndex( buf, max, index, 2, &indexCount );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( 6, indexCount );
+    jsonStatus = JSON_ValidateAndIndex( buf, max, NULL, 0, &indexCount );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( 6, indexCount );
+
+    /* Validation results are those of JSON_Validate(). */
+    jsonStatus = JSON_ValidateAndIndex( "1 ", 2, NULL, 0, &indexCount );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, indexCount );
+    jsonStatus = JSON_ValidateAndIndex( "[1] x", 5, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_ValidateAndIndex( "[1", 2, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSON_Validate( "[1", 2 ), jsonStatus );
+    jsonStatus = JSON_ValidateAndIndex( "[1]]", 4, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_ValidateAndIndex( "]", 1, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* Searching a document that was not validated. */
+    jsonStatus = JSON_SearchIndexed( "[{,]", 4, NULL, 0, "[1]", 3, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_ValidateAndIndex( NULL, max, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ValidateAndIndex( buf, max, index, 6, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ValidateAndIndex( buf, max, NULL, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ValidateAndIndex( buf, 0, index, 6, &indexCount );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_SearchIndexed( NULL, max, index, 6, "e", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, max, NULL, 6, "e", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, max, index, 6, NULL, 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, max, index, 6, "e", 1, NULL, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, max, index, 6, "e", 1, &value, NULL, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, 0, index, 6, "e", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( buf, max, index, 6, "e", 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_SearchIndexed( "  ", 2, NULL, 0, "e", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+}
+
+/**
+ * @brief Test a key table agrees with JSON_ObjectFind().
+ */
+void test_JSON_KeyIndex( void )
+{
+    JSONStatus_t jsonStatus, expectedStatus;
+    char buf[] = "{\"doc\":{\"a\":1,\"bb\":[1,2],\"c\":{\"a\":2},\"a\":5,\"\":0,\"q\\\"\":\"x\"},\"z\":0}";
+    size_t max = sizeof( buf ) - 1;
+    JSONCursor_t doc, object, value, expectedValue;
+    JSONKeySlot_t table[ 16 ];
+    size_t i, capacity, keyCount;
+    const char * keys[] = { "a", "bb", "c", "", "q\\\"", "b", "x", "aa", "z" };
+
+    jsonStatus = JSON_DocOpen( buf, max, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_ObjectFind( &doc, "doc", 3, &object );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    /* Lookups agree with JSON_ObjectFind(), with a full table and
+     * with one that has long runs of slots. */
+    for( capacity = 5; capacity <= 16; capacity += 11 )
+    {
+        jsonStatus = JSON_KeyIndexBuild( &object, table, capacity, &keyCount );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 6, keyCount );
+
+        for( i = 0; i < ( sizeof( keys ) / sizeof( keys[ 0 ] ) ); i++ )
+        {
+            expectedStatus = JSON_ObjectFind( &object, keys[ i ], strlen( keys[ i ] ), &expectedValue );
+            jsonStatus = JSON_KeyIndexFind( &object, table, capacity, keys[ i ], strlen( keys[ i ] ), &value );
+            TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+
+            if( jsonStatus == JSONSuccess )
+            {
+                TEST_ASSERT_EQUAL_PTR( buf, value.buf );
+                TEST_ASSERT_EQUAL( max, value.max );
+                TEST_ASSERT_EQUAL( expectedValue.start, value.start );
+            }
+        }
+    }
+
+    /* Slots outside the buffer are ignored. */
+    for( i = 0; i < 16; i++ )
+    {
+        table[ i ].key = 1;
+        table[ i ].keyLength = 2;
+        table[ i ].value = 1;
+    }
+
+    table[ 0 ].key = max;
+    table[ 1 ].key = max - 1;
+    table[ 2 ].value = max;
+    jsonStatus = JSON_KeyIndexFind( &object, table, 3, "bb", 2, &value );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* A table that is too small is counted in full. */
+    jsonStatus = JSON_KeyIndexBuild( &object, table, 4, &keyCount );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( 6, keyCount );
+
+    /* Objects that are empty, or not objects, or not valid. */
+    jsonStatus = JSON_DocOpen( " { } ", 5, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &doc, table, 1, &keyCount );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, keyCount );
+    jsonStatus = JSON_KeyIndexFind( &doc, table, 1, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_DocOpen( "[1]", 3, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &doc, table, 1, &keyCount );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_DocOpen( "{\"a\":1,\"b\":x}", 13, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &doc, table, 4, &keyCount );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, keyCount );
+    jsonStatus = JSON_DocOpen( "{\"a\":1,2}", 9, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &doc, table, 4, &keyCount );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 1, keyCount );
+    jsonStatus = JSON_DocOpen( "{\"a\":1,", 7, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &doc, table, 4, &keyCount );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_KeyIndexBuild( NULL, table, 16, &keyCount );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &object, NULL, 16, &keyCount );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &object, table, 16, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexBuild( &object, table, 0, &keyCount );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_KeyIndexFind( NULL, table, 16, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexFind( &object, NULL, 16, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexFind( &object, table, 16, NULL, 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexFind( &object, table, 16, "a", 1, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_KeyIndexFind( &object, table, 0, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test reading array elements by position.
+ */
+void test_JSON_ArrayIndex( void )
+{
+    JSONStatus_t jsonStatus, expectedStatus;
+    char buf[] = " [ 1 , \"ab\" , [2,3] , {\"k\":[]} , true ] ";
+    size_t max = sizeof( buf ) - 1;
+    size_t offsets[ 5 ];
+    size_t i, count;
+    char query[ 4 ] = "[0]";
+    const char * value, * expectedValue;
+    size_t valueLength, expectedValueLength;
+    JSONTypes_t type, expectedType;
+
+    jsonStatus = JSON_ArrayIndexBuild( buf, max, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 5, count );
+
+    /* Each element, and one past the last, agree with JSON_SearchConst(). */
+    for( i = 0; i <= count; i++ )
+    {
+        query[ 1 ] = ( char ) ( '0' + i );
+        expectedStatus = JSON_SearchConst( buf, max, query, 3,
+                                           &expectedValue, &expectedValueLength, &expectedType );
+        jsonStatus = JSON_ArrayAt( buf, max, offsets, count, i, &value, &valueLength, &type );
+        TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+
+        if( jsonStatus == JSONSuccess )
+        {
+            TEST_ASSERT_EQUAL_PTR( expectedValue, value );
+            TEST_ASSERT_EQUAL( expectedValueLength, valueLength );
+            TEST_ASSERT_EQUAL( expectedType, type );
+        }
+    }
+
+    jsonStatus = JSON_ArrayAt( buf, max, offsets, count, 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, valueLength );
+
+    /* Indexes that do not begin an element are reported. */
+    offsets[ 0 ] = 5;
+    offsets[ 1 ] = max;
+    jsonStatus = JSON_ArrayAt( buf, max, offsets, count, 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_ArrayAt( buf, max, offsets, count, 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    /* So are values that are not delimited as elements. */
+    {
+        const char * other = "[\"abc 123\",1 2,\t{\"k\":5} ,\n\r6";
+        size_t otherOffsets[] = { 0, 6, 11, 21, 16, 27 };
+
+        for( i = 0; i < 4; i++ )
+        {
+            jsonStatus = JSON_ArrayAt( other, strlen( other ), otherOffsets, 6, i, &value, &valueLength, NULL );
+            TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+        }
+
+        jsonStatus = JSON_ArrayAt( other, strlen( other ), otherOffsets, 6, 4, &value, &valueLength, NULL );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        TEST_ASSERT_EQUAL( 7, valueLength );
+        jsonStatus = JSON_ArrayAt( other, strlen( other ), otherOffsets, 6, 5, &value, &valueLength, NULL );
+        TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    }
+
+    /* Too few indexes: the array is still counted. */
+    jsonStatus = JSON_ArrayIndexBuild( buf, max, offsets, 2, &count );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( 5, count );
+    jsonStatus = JSON_ArrayIndexBuild( buf, max, NULL, 0, &count );
+    TEST_ASSERT_EQUAL( JSONInsufficientMemory, jsonStatus );
+    TEST_ASSERT_EQUAL( 5, count );
+
+    /* Empty arrays, and buffers that do not hold one valid array. */
+    jsonStatus = JSON_ArrayIndexBuild( "[ ]", 3, NULL, 0, &count );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, count );
+    jsonStatus = JSON_ArrayIndexBuild( "[]", 2, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, count );
+    jsonStatus = JSON_ArrayIndexBuild( "[1] [", 5, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( "[1,2] 3", 7, offsets, 1, &count );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( "{}", 2, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( "[1,x]", 5, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, count );
+    jsonStatus = JSON_ArrayIndexBuild( "[1,", 3, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( "  ", 2, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, count );
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_ArrayIndexBuild( NULL, max, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( buf, max, offsets, 5, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( buf, max, NULL, 5, &count );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayIndexBuild( buf, 0, offsets, 5, &count );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_ArrayAt( NULL, max, offsets, 5, 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayAt( buf, max, NULL, 5, 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayAt( buf, max, offsets, 5, 0, NULL, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayAt( buf, max, offsets, 5, 0, &value, NULL, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_ArrayAt( buf, 0, offsets, 5, 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_ArrayAt( buf, max, NULL, 0, 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+}
+
+/**
+ * @brief Test counting the members of a collection.
+ */
+void test_JSON_Count( void )
+{
+    JSONStatus_t jsonStatus;
+    size_t i, count;
+    struct
+    {
+        const char * doc;
+        JSONStatus_t expected;
+        size_t count;
+    }
+    cases[] =
+    {
+        { "[]",                                          JSONSuccess,         0 },
+        { " [ \n ] ",                                    JSONSuccess,         0 },
+        { "{}",                                          JSONSuccess,         0 },
+        { "[1]",                                         JSONSuccess,         1 },
+        { "[1, 2 ,3]",                                   JSONSuccess,         3 },
+        { "[\t1,\r\n2 ]",                                JSONSuccess,         2 },
+        { "[[],[[1,2]],{},[]]",                          JSONSuccess,         4 },
+        { "{\"a\":1,\"b\":[1,2],\"c\":{\"d\":\",]}\"}}", JSONSuccess, 3 },
+        { "[\"a\\\"],\",\"\\\\\",1]",                     JSONSuccess,         3 },
+        { "[1] [2,3]",                                   JSONSuccess,         1 },
+        { "[1,2",                                        JSONPartial,         0 },
+        { "[[1,2]",                                      JSONPartial,         0 },
+        { "[\"ab",                                       JSONPartial,         0 },
+        { "[\"ab\\",                                     JSONPartial,         0 },
+        { "   ",                                         JSONPartial,         0 },
+        { "1",                                           JSONIllegalDocument, 0 },
+        { "\"[1]\"",                                     JSONIllegalDocument, 0 },
+    };
+
+    for( i = 0; i < ( sizeof( cases ) / sizeof( cases[ 0 ] ) ); i++ )
+    {
+        count = 99;
+        jsonStatus = JSON_Count( cases[ i ].doc, strlen( cases[ i ].doc ), &count );
+        TEST_ASSERT_EQUAL( cases[ i ].expected, jsonStatus );
+
+        if( jsonStatus == JSONSuccess )
+        {
+            TEST_ASSERT_EQUAL( cases[ i ].count, count );
+        }
+    }
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_Count( NULL, 2, &count );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_Count( "[]", 2, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_Count( "[]", 0, &count );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test searches of a valid buffer that look for the bytes of each key.
+ */
+void test_JSON_SearchTrusted( void )
+{
+    JSONStatus_t jsonStatus, expectedStatus;
+    const char * value, * expectedValue;
+    size_t d, q, valueLength, expectedValueLength;
+    JSONTypes_t type, expectedType;
+    const char * docs[] =
+    {
+        "{\"a\":\"\\\"b\\\":1\",\"b\":{\"b\":2},\"c\":[\"b\",{\"b\":3}],\"b\":4}",
+        " { \"k\" : 1 , \"key\" : [ \"key\" , { \"key\" : true } ] , \"ke\" : null } ",
+        "{\"v\":\"a\",\"a\":\"v\",\"axc\":1,\"abc\":2}",
+        "{\"a\\\\\":1,\"a\\\":1\":2,\"b\":\"a\"}",
+        "{\"x\":\"\\\"a\",\"a\":1}",
+        "[{\"x\":1},{\"a\":2}]",
+        "{\"x\":{\"y\":1}}",
+        "[1 ,2\t,3\n,4\r,\"x,\",{\"b\":[1]},[5]]",
+        "{}",
+        "[]",
+        "\"a\"",
+    };
+    const char * queries[] =
+    {
+        "a",      "b",   "b.b",   "c[1].b", "c[0]", "key", "key[1].key", "key[0]", "key[2]",
+        "ke",     "k",   "kez",   "v",      "abc",  "a\\", "a\\\\",      "[1].a",  "[0].a",
+        "x.y",    "y",   "[0]",   "a.",     "b[",   ",",     "[4]",        "[5].b",  "[6][0]",
+    };
+
+    /* A valid buffer gives the same results as JSON_SearchConst(). */
+    for( d = 0; d < ( sizeof( docs ) / sizeof( docs[ 0 ] ) ); d++ )
+    {
+        for( q = 0; q < ( sizeof( queries ) / sizeof( queries[ 0 ] ) ); q++ )
+        {
+            expectedStatus = JSON_SearchConst( docs[ d ], strlen( docs[ d ] ), queries[ q ], strlen( queries[ q ] ),
+                                               &expectedValue, &expectedValueLength, &expectedType );
+            jsonStatus = JSON_SearchTrusted( docs[ d ], strlen( docs[ d ] ), queries[ q ], strlen( queries[ q ] ),
+                                             &value, &valueLength, &type );
+            TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+
+            if( jsonStatus == JSONSuccess )
+            {
+                TEST_ASSERT_EQUAL_PTR( expectedValue, value );
+                TEST_ASSERT_EQUAL( expectedValueLength, valueLength );
+                TEST_ASSERT_EQUAL( expectedType, type );
+            }
+        }
+    }
+
+    jsonStatus = JSON_SearchTrusted( docs[ 0 ], strlen( docs[ 0 ] ), "b", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "{\"b\":2}", value, valueLength );
+
+    /* A buffer that ends early is not read past its end. */
+    jsonStatus = JSON_SearchTrusted( "{\"a\":", 5, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "{\"a\":[1", 7, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "{\"x\":\"a\"", 8, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "{\"x\":\"\\\"a\\\"", 11, "a\\", 2, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "{", 1, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "  ", 2, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "[\"x", 3, "[1]", 3, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( "[,1]", 4, "[1]", 3, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_SearchTrusted( NULL, 2, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( docs[ 0 ], 2, NULL, 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( docs[ 0 ], 2, "a", 1, NULL, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( docs[ 0 ], 2, "a", 1, &value, NULL, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( docs[ 0 ], 0, "a", 1, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_SearchTrusted( docs[ 0 ], 2, "a", 0, &value, &valueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test searches that stop at the first byte of the value found.
+ */
+void test_JSON_SearchStart( void )
+{
+    JSONStatus_t jsonStatus, expectedStatus;
+    const char * value, * expectedValue;
+    size_t d, q, expectedValueLength;
+    JSONTypes_t type, expectedType;
+    const char * docs[] =
+    {
+        "{\"a\":\"x\",\"b\":{\"c\":[1,true,null]},\"d\":-1.5e3,\"e\":false}",
+        " [ { \"a\" : \"\" } , [ 2 , \"y\" ] ] ",
+        "{\"a\\\"\":{},\"a\":[]}",
+        "42",
+    };
+    const char * queries[] =
+    {
+        "a", "b", "b.c", "b.c[0]", "b.c[1]", "b.c[2]", "b.c[3]", "d", "e", "f",
+        "[0]", "[0].a", "[1][1]", "[2]", "a\\\"", "a.", "[x]",
+    };
+
+    /* The value found is the one found by JSON_SearchConst(). */
+    for( d = 0; d < ( sizeof( docs ) / sizeof( docs[ 0 ] ) ); d++ )
+    {
+        for( q = 0; q < ( sizeof( queries ) / sizeof( queries[ 0 ] ) ); q++ )
+        {
+            expectedStatus = JSON_SearchConst( docs[ d ], strlen( docs[ d ] ), queries[ q ], strlen( queries[ q ] ),
+                                               &expectedValue, &expectedValueLength, &expectedType );
+            jsonStatus = JSON_SearchStart( docs[ d ], strlen( docs[ d ] ), queries[ q ], strlen( queries[ q ] ),
+                                           &value, &type );
+            TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+            TEST_ASSERT_EQUAL( expectedStatus, JSON_Exists( docs[ d ], strlen( docs[ d ] ), queries[ q ], strlen( queries[ q ] ) ) );
+
+            if( jsonStatus == JSONSuccess )
+            {
+                TEST_ASSERT_EQUAL( expectedType, type );
+                TEST_ASSERT_EQUAL_PTR( ( expectedType == JSONString ) ? ( expectedValue - 1 ) : expectedValue, value );
+            }
+        }
+    }
+
+    /* The value found is not read, but the values before it are. */
+    jsonStatus = JSON_SearchStart( "{\"a\":[1,,],\"b\":2}", 17, "a", 1, &value, &type );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONArray, type );
+    TEST_ASSERT_EQUAL( '[', *value );
+    jsonStatus = JSON_SearchStart( "{\"a\":[1,,],\"b\":2}", 17, "b", 1, &value, NULL );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_Exists( "{\"a\":{\"b\":", 10, "a", 1 );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_Exists( "{\"a\":{\"b\":", 10, "a.b", 3 );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_Exists( "  ", 2, "a", 1 );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* A value that is missing is not found. */
+    jsonStatus = JSON_Exists( "{\"a\":}", 6, "a", 1 );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_Exists( "{\"a\":,\"b\":1}", 12, "a", 1 );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_Exists( "[ ]", 3, "[0]", 3 );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    jsonStatus = JSON_Exists( "[,1]", 4, "[0]", 3 );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* Neither is a value after one that is not valid, or no value. */
+    {
+        const struct
+        {
+            const char * doc;
+            const char * query;
+        }
+        missing[] =
+        {
+            { "{ ",     "a"   },
+            { "[ ",     "[0]" },
+            { "{1:2}",  "a"   },
+            { "{\"a\":]", "a"   },
+            { "[}",     "[0]" },
+            { "[x,1]",  "[1]" },
+        };
+
+        for( d = 0; d < ( sizeof( missing ) / sizeof( missing[ 0 ] ) ); d++ )
+        {
+            jsonStatus = JSON_Exists( missing[ d ].doc, strlen( missing[ d ].doc ),
+                                      missing[ d ].query, strlen( missing[ d ].query ) );
+            TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+        }
+    }
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_SearchStart( NULL, 2, "a", 1, &value, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchStart( docs[ 0 ], 2, NULL, 1, &value, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchStart( docs[ 0 ], 2, "a", 1, NULL, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchStart( docs[ 0 ], 0, "a", 1, &value, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    jsonStatus = JSON_Exists( docs[ 0 ], 2, "a", 0 );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test searches that begin at a cursor.
+ */
+void test_JSON_SearchFrom( void )
+{
+    JSONStatus_t jsonStatus, expectedStatus;
+    JSONCursor_t doc, prefix, value, bad;
+    const char * expectedValue;
+    size_t i;
+    const char buf[] = " {\"a\":{\"b\":[1,{\"c\":\"x\"}],\"d\":{}},\"e\":[[2,3]]} ";
+    size_t max = sizeof( buf ) - 1;
+    const struct
+    {
+        const char * prefix;
+        const char * rest;
+        const char * whole;
+    }
+    queries[] =
+    {
+        { "a",    "b[1].c", "a.b[1].c" },
+        { "a.b",  "[1].c",  "a.b[1].c" },
+        { "a.b",  "[0]",    "a.b[0]"   },
+        { "a",    "d",      "a.d"      },
+        { "e",    "[0][1]", "e[0][1]"  },
+        { "e[0]", "[1]",    "e[0][1]"  },
+        { "a",    "x",      "a.x"      },
+        { "a",    "[0]",    "a[0]"     },
+        { "e",    "a",      "e.a"      },
+        { "a",    "b.",     "a.b."     },
+    };
+
+    jsonStatus = JSON_DocOpen( buf, max, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    /* A query split in two finds the same value as JSON_SearchStart(). */
+    for( i = 0; i < ( sizeof( queries ) / sizeof( queries[ 0 ] ) ); i++ )
+    {
+        expectedStatus = JSON_SearchStart( buf, max, queries[ i ].whole, strlen( queries[ i ].whole ),
+                                           &expectedValue, NULL );
+        jsonStatus = JSON_SearchFrom( &doc, queries[ i ].prefix, strlen( queries[ i ].prefix ), &prefix );
+        TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+        jsonStatus = JSON_SearchFrom( &prefix, queries[ i ].rest, strlen( queries[ i ].rest ), &value );
+        TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+
+        if( jsonStatus == JSONSuccess )
+        {
+            TEST_ASSERT_EQUAL_PTR( buf, value.buf );
+            TEST_ASSERT_EQUAL( max, value.max );
+            TEST_ASSERT_EQUAL_PTR( expectedValue, &buf[ value.start ] );
+        }
+    }
+
+    /* The value found may replace the cursor searched. */
+    value = doc;
+    jsonStatus = JSON_SearchFrom( &value, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &value, "d", 1, &value );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( '{', buf[ value.start ] );
+    jsonStatus = JSON_SearchFrom( &value, "z", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    /* Only the bytes read are validated. */
+    jsonStatus = JSON_DocOpen( "{\"a\":1,\"b\":[}", 13, &bad );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &bad, "b", 1, &value );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &value, "[1]", 3, &value );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &bad, "c", 1, &value );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_SearchFrom( NULL, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &doc, NULL, 1, &value );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &doc, "a", 1, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchFrom( &doc, "a", 0, &value );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    bad.start = bad.max;
+    jsonStatus = JSON_SearchFrom( &bad, "a", 1, &value );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Search each element and check the values matched, by the bytes
+ * with which they begin.
+ */
+static void searchEachCheck( const JSONCursor_t * cursor,
+                             const char * query,
+                             JSONStatus_t expectedStatus,
+                             const char * const * expected,
+                             size_t expectedCount )
+{
+    JSONStatus_t jsonStatus;
+    matches_t matches = { { 0 }, 0, SIZE_MAX };
+    size_t i;
+
+    jsonStatus = JSON_SearchEach( cursor, query, strlen( query ), matchCollect, &matches );
+    TEST_ASSERT_EQUAL( expectedStatus, jsonStatus );
+    TEST_ASSERT_EQUAL( expectedCount, matches.count );
+
+    for( i = 0; i < expectedCount; i++ )
+    {
+        TEST_ASSERT_EQUAL_STRING_LEN( expected[ i ], matches.starts[ i ], strlen( expected[ i ] ) );
+    }
+}
+
+/**
+ * @brief Test searches with a wildcard index.
+ */
+void test_JSON_SearchEach( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONCursor_t doc, n, bad;
+    matches_t matches = { { 0 }, 0, 2 };
+    const char buf[] = "{\"items\":[{\"id\":1},{\"name\":\"x\"},{\"id\":\"b\",\"id2\":3},[],{\"id\":{\"k\":[4]}}],"
+                       "\"n\":[[1,2],[3]],\"e\":[ ],\"s\":\"t\"}";
+    const char * ids[] = { "1}", "\"b\"", "{\"k\"" };
+    const char * items[] = { "{\"id\":1}", "{\"name\"", "{\"id\":\"b\"", "[]", "{\"id\":{" };
+    const char * second[] = { "2]" };
+    const char * first[] = { "1,", "3]" };
+    const char * nested[] = { "4]" };
+    const char * whole[] = { "[[1,2]" };
+    const char * partial[] = { "1,", "2" };
+    const char * unclosed[] = { "[}" };
+
+    jsonStatus = JSON_DocOpen( buf, sizeof( buf ) - 1, &doc );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    /* Each match is given in document order; other elements are passed over. */
+    searchEachCheck( &doc, "items[*].id", JSONSuccess, ids, 3 );
+    searchEachCheck( &doc, "items[*]", JSONSuccess, items, 5 );
+    searchEachCheck( &doc, "items[*].id.k[0]", JSONSuccess, nested, 1 );
+    searchEachCheck( &doc, "n[*][1]", JSONSuccess, second, 1 );
+    searchEachCheck( &doc, "n[*][0]", JSONSuccess, first, 2 );
+    searchEachCheck( &doc, "n[0][*]", JSONSuccess, partial, 2 );
+    searchEachCheck( &doc, "e[*]", JSONSuccess, NULL, 0 );
+    searchEachCheck( &doc, "n", JSONSuccess, whole, 1 );
+    searchEachCheck( &doc, "s[*]", JSONNotFound, NULL, 0 );
+    searchEachCheck( &doc, "x[*]", JSONNotFound, NULL, 0 );
+    searchEachCheck( &doc, "x", JSONNotFound, NULL, 0 );
+    searchEachCheck( &doc, "[*]", JSONNotFound, NULL, 0 );
+
+    /* A cursor from an earlier search may be searched. */
+    jsonStatus = JSON_SearchFrom( &doc, "n", 1, &n );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    searchEachCheck( &n, "[*][0]", JSONSuccess, first, 2 );
+
+    /* The callback may stop the search. */
+    jsonStatus = JSON_SearchEach( &doc, "items[*]", 8, matchCollect, &matches );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 2, matches.count );
+
+    /* A malformed query is reported before anything is read. */
+    searchEachCheck( &doc, "e[*][*]", JSONBadParameter, NULL, 0 );
+    searchEachCheck( &doc, "e[*].", JSONBadParameter, NULL, 0 );
+    searchEachCheck( &doc, "e.[*]", JSONBadParameter, NULL, 0 );
+    searchEachCheck( &doc, "e[*].a..b", JSONBadParameter, NULL, 0 );
+    searchEachCheck( &doc, "e[*", JSONBadParameter, NULL, 0 );
+    searchEachCheck( &doc, "e[*x]", JSONBadParameter, NULL, 0 );
+
+    /* Errors stop the search at the element where they are met. */
+    jsonStatus = JSON_DocOpen( "{\"a\":[1,2", 9, &bad );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    searchEachCheck( &bad, "a[*]", JSONPartial, partial, 2 );
+    jsonStatus = JSON_DocOpen( "{\"a\":[1,}]}", 11, &bad );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    searchEachCheck( &bad, "a[*]", JSONIllegalDocument, first, 1 );
+    jsonStatus = JSON_DocOpen( "{\"a\":[[}]}", 10, &bad );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    searchEachCheck( &bad, "a[*]", JSONIllegalDocument, unclosed, 1 );
+    jsonStatus = JSON_DocOpen( "{\"a\":[{\"b\":[}]}", 15, &bad );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    searchEachCheck( &bad, "a[*].c", JSONIllegalDocument, NULL, 0 );
+
+    /* Invalid parameters. */
+    jsonStatus = JSON_SearchEach( NULL, "a", 1, matchCollect, &matches );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchEach( &doc, NULL, 1, matchCollect, &matches );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchEach( &doc, "a", 1, NULL, &matches );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+    jsonStatus = JSON_SearchEach( &doc, "a", 0, matchCollect, &matches );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+    bad.start = bad.max;
+    jsonStatus = JSON_SearchEach( &bad, "a", 1, matchCollect, &matches );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
 }
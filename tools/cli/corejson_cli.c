@@ -0,0 +1,388 @@
+/*
+ * coreJSON
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file corejson_cli.c
+ * @brief A command-line tool to validate, search, and list JSON files.
+ *
+ * Files are memory-mapped rather than read, so multi-gigabyte documents
+ * are scanned without copying.  The time taken by each command and the
+ * resulting throughput are printed to stderr.
+ *
+ * Usage:
+ *     corejson-cli validate FILE...
+ *     corejson-cli search FILE QUERY
+ *     corejson-cli iterate FILE
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core_json.h"
+
+/**
+ * @brief A memory-mapped file.
+ */
+typedef struct
+{
+    const char * buf;
+    size_t length;
+} mappedFile_t;
+
+/**
+ * @brief Names for JSONStatus_t values.
+ */
+static const char * const statusNames[] =
+{
+    "JSONPartial",
+    "JSONSuccess",
+    "JSONIllegalDocument",
+    "JSONMaxDepthExceeded",
+    "JSONNotFound",
+    "JSONNullParameter",
+    "JSONBadParameter",
+    "JSONInsufficientMemory"
+};
+
+/**
+ * @brief Names for JSONTypes_t values.
+ */
+static const char * const typeNames[] =
+{
+    "invalid",
+    "string",
+    "number",
+    "true",
+    "false",
+    "null",
+    "object",
+    "array"
+};
+
+/**
+ * @brief Map a file into memory for sequential reading.
+ *
+ * @param[in] path  The file to map.
+ * @param[out] file  The mapping.
+ *
+ * @return 0 on success; -1 otherwise, after printing an error.
+ */
+static int mapFile( const char * path,
+                    mappedFile_t * file )
+{
+    int ret = -1;
+    int fd;
+    struct stat st;
+    void * p;
+
+    fd = open( path, O_RDONLY );
+
+    if( fd < 0 )
+    {
+        fprintf( stderr, "%s: %s\n", path, strerror( errno ) );
+    }
+    else if( fstat( fd, &st ) != 0 )
+    {
+        fprintf( stderr, "%s: %s\n", path, strerror( errno ) );
+    }
+    else if( st.st_size == 0 )
+    {
+        /* An empty file cannot be mapped; JSON_Validate rejects it anyway. */
+        file->buf = "";
+        file->length = 0U;
+        ret = 0;
+    }
+    else
+    {
+        p = mmap( NULL, ( size_t ) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( p == MAP_FAILED )
+        {
+            fprintf( stderr, "%s: %s\n", path, strerror( errno ) );
+        }
+        else
+        {
+            /* The library reads each document once, front to back. */
+            ( void ) posix_madvise( p, ( size_t ) st.st_size, POSIX_MADV_SEQUENTIAL );
+            file->buf = p;
+            file->length = ( size_t ) st.st_size;
+            ret = 0;
+        }
+    }
+
+    if( fd >= 0 )
+    {
+        ( void ) close( fd );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Release a mapping made by mapFile().
+ *
+ * @param[in] file  The mapping.
+ */
+static void unmapFile( mappedFile_t * file )
+{
+    if( file->length > 0U )
+    {
+        ( void ) munmap( ( void * ) file->buf, file->length );
+    }
+}
+
+/**
+ * @brief Read a monotonic clock.
+ *
+ * @return the time in seconds.
+ */
+static double now( void )
+{
+    struct timespec ts;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ( double ) ts.tv_sec + ( ( double ) ts.tv_nsec / 1e9 );
+}
+
+/**
+ * @brief Print the time taken to process some bytes, and the throughput.
+ *
+ * @param[in] label  What was timed.
+ * @param[in] length  The number of bytes processed.
+ * @param[in] seconds  The time taken.
+ */
+static void printThroughput( const char * label,
+                             size_t length,
+                             double seconds )
+{
+    double mbps = 0.0;
+
+    if( seconds > 0.0 )
+    {
+        mbps = ( ( double ) length / 1e6 ) / seconds;
+    }
+
+    fprintf( stderr, "%s: %zu bytes in %.6f s (%.1f MB/s)\n",
+             label, length, seconds, mbps );
+}
+
+/**
+ * @brief Validate each file.
+ *
+ * @param[in] paths  The files to validate.
+ * @param[in] count  The number of files.
+ *
+ * @return 0 if every file is valid; 1 otherwise.
+ */
+static int cmdValidate( char * const * paths,
+                        int count )
+{
+    int ret = 0;
+    int i;
+    mappedFile_t file;
+    JSONStatus_t result;
+    double t;
+
+    for( i = 0; i < count; i++ )
+    {
+        if( mapFile( paths[ i ], &file ) != 0 )
+        {
+            ret = 1;
+        }
+        else
+        {
+            t = now();
+            result = JSON_Validate( file.buf, file.length );
+            t = now() - t;
+
+            printf( "%s: %s\n", paths[ i ], statusNames[ result ] );
+            printThroughput( paths[ i ], file.length, t );
+
+            if( result != JSONSuccess )
+            {
+                ret = 1;
+            }
+
+            unmapFile( &file );
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Search a file, and print the value found.
+ *
+ * @param[in] path  The file to search.
+ * @param[in] query  The query, as for JSON_SearchConst().
+ *
+ * @return 0 if the value is found; 1 otherwise.
+ */
+static int cmdSearch( const char * path,
+                      const char * query )
+{
+    int ret = 1;
+    mappedFile_t file;
+    JSONStatus_t result;
+    const char * value;
+    size_t valueLength;
+    JSONTypes_t type;
+    double t;
+
+    if( mapFile( path, &file ) == 0 )
+    {
+        t = now();
+        result = JSON_Validate( file.buf, file.length );
+
+        if( result == JSONSuccess )
+        {
+            result = JSON_SearchConst( file.buf, file.length, query, strlen( query ),
+                                       &value, &valueLength, &type );
+        }
+
+        t = now() - t;
+
+        if( result == JSONSuccess )
+        {
+            printf( "(%s) %.*s\n", typeNames[ type ], ( int ) valueLength, value );
+            ret = 0;
+        }
+        else
+        {
+            printf( "%s: %s\n", path, statusNames[ result ] );
+        }
+
+        printThroughput( path, file.length, t );
+        unmapFile( &file );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief List the members of the outermost collection of a file.
+ *
+ * @param[in] path  The file to list.
+ *
+ * @return 0 if the file is valid; 1 otherwise.
+ */
+static int cmdIterate( const char * path )
+{
+    int ret = 1;
+    mappedFile_t file;
+    JSONStatus_t result;
+    JSONPair_t pair;
+    size_t start = 0U, next = 0U;
+    double t;
+
+    if( mapFile( path, &file ) == 0 )
+    {
+        t = now();
+        result = JSON_Validate( file.buf, file.length );
+
+        if( result == JSONSuccess )
+        {
+            ret = 0;
+            result = JSON_Iterate( file.buf, file.length, &start, &next, &pair );
+        }
+        else
+        {
+            printf( "%s: %s\n", path, statusNames[ result ] );
+        }
+
+        while( result == JSONSuccess )
+        {
+            if( pair.key != NULL )
+            {
+                printf( "%.*s\t", ( int ) pair.keyLength, pair.key );
+            }
+
+            printf( "(%s) %.*s\n", typeNames[ pair.jsonType ],
+                    ( int ) pair.valueLength, pair.value );
+
+            result = JSON_Iterate( file.buf, file.length, &start, &next, &pair );
+        }
+
+        t = now() - t;
+
+        printThroughput( path, file.length, t );
+        unmapFile( &file );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Print the usage message.
+ *
+ * @param[in] name  The name of the program.
+ *
+ * @return 2, the exit status for a usage error.
+ */
+static int usage( const char * name )
+{
+    fprintf( stderr,
+             "usage: %s validate FILE...\n"
+             "       %s search FILE QUERY\n"
+             "       %s iterate FILE\n",
+             name, name, name );
+
+    return 2;
+}
+
+int main( int argc,
+          char ** argv )
+{
+    int ret;
+
+    if( argc < 3 )
+    {
+        ret = usage( argv[ 0 ] );
+    }
+    else if( strcmp( argv[ 1 ], "validate" ) == 0 )
+    {
+        ret = cmdValidate( &argv[ 2 ], argc - 2 );
+    }
+    else if( ( strcmp( argv[ 1 ], "search" ) == 0 ) && ( argc == 4 ) )
+    {
+        ret = cmdSearch( argv[ 2 ], argv[ 3 ] );
+    }
+    else if( ( strcmp( argv[ 1 ], "iterate" ) == 0 ) && ( argc == 3 ) )
+    {
+        ret = cmdIterate( argv[ 2 ] );
+    }
+    else
+    {
+        ret = usage( argv[ 0 ] );
+    }
+
+    return ret;
+}